@@ -0,0 +1,416 @@
+#include "Calendar.h"
+
+/*
+ * An entry of a day's bucket: a reservation, with the fields it's sorted by.
+ */
+typedef struct CalendarEntry_t {
+	int hour; //The hour of the reservation.
+	TechnionFaculty faculty; //The faculty of the reserved room.
+	int room_id; //The id of the reserved room.
+	Reservation reservation; //The reservation.
+	Room room; //The reserved room.
+	struct Company_t* company; //The company that owns the reserved room.
+} CalendarEntry;
+
+/*
+ * The bucket of a single day: an array of entries, sorted by hour, then by
+ * faculty and then by room id.
+ */
+typedef struct DayBucket_t {
+	CalendarEntry* entries; //The bucket's entries.
+	int capacity; //The amount of entries the array can hold.
+	int size; //The amount of entries in the bucket.
+} DayBucket;
+
+/*
+ * The bucket of a day that's too far away for the wheel.
+ */
+typedef struct FarDay_t {
+	int day; //The day.
+	DayBucket bucket; //The day's reservations.
+} FarDay;
+
+/*
+ * Implementation of the Calendar ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "Calendar".
+ * The calendar is a wheel of buckets: the bucket of a day is in the slot of
+ * the day modulo the capacity, which is always a power of 2. The wheel covers
+ * the days from today up to (not including) today+capacity, and it grows up
+ * to MAX_DAYS slots. The buckets of the days after that are kept in an array
+ * sorted by day, and each of them moves into the wheel when the wheel reaches
+ * its day.
+ */
+struct Calendar_t {
+	DayBucket* buckets; //The wheel's slots.
+	int capacity; //The amount of slots (days) in the wheel.
+	int today; //The first day that the wheel covers.
+	FarDay* far_days; //The buckets of the days after the wheel, by day.
+	int far_amount; //The amount of far days in the array.
+	int far_capacity; //The amount of far days the array can hold.
+};
+
+//The initial amount of days the wheel covers. Must be a power of 2.
+#define INITIAL_DAYS 32
+
+//The most days the wheel covers. Must be a power of 2.
+#define MAX_DAYS 256
+
+//The initial amount of entries in a day's bucket.
+#define INITIAL_BUCKET_SIZE 4
+
+//The wheel and the buckets grow by this factor each time.
+#define GROWTH_FACTOR 2
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for assigning a value to a pointer iff it's not NULL.
+ */
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+/*
+ * A macro for the slot of a day in the wheel.
+ */
+#define DAY_SLOT(calendar, day) ((day) & ((calendar)->capacity - 1))
+
+static bool isCovered(Calendar calendar, int day);
+static int compareEntry(CalendarEntry* entry, int hour,
+TechnionFaculty faculty, int room_id);
+static int findPlace(DayBucket* bucket, int hour, TechnionFaculty faculty,
+int room_id, bool* found);
+static bool growWheel(Calendar calendar, int day);
+static bool growBucket(DayBucket* bucket);
+static int findFarDay(Calendar calendar, int day, bool* found);
+static DayBucket* findBucket(Calendar calendar, int day);
+static DayBucket* addFarDay(Calendar calendar, int day);
+static void removeFarDay(Calendar calendar, int place);
+static void drainFarDays(Calendar calendar);
+
+/*
+ * A static function that checks if a day is covered by the wheel.
+ */
+static bool isCovered(Calendar calendar, int day) {
+	assert(calendar);
+	return ((day >= calendar->today) &&
+	(day - calendar->today < calendar->capacity));
+}
+
+/*
+ * A static function that compares an entry with a (hour, faculty, id) key.
+ * #return:
+ * 	A negative number if the entry comes before the key, 0 if they're equal and
+ * 	a positive number otherwise.
+ */
+static int compareEntry(CalendarEntry* entry, int hour,
+TechnionFaculty faculty, int room_id) {
+	assert(entry);
+	if(entry->hour != hour)
+		return (entry->hour - hour);
+	if(entry->faculty != faculty)
+		return ((int)(entry->faculty) - (int)faculty);
+	return (entry->room_id - room_id);
+}
+
+/*
+ * A static function that finds the place of a key in a bucket (binary search).
+ * 	$found: Address where we store whether the key is in the bucket.
+ * #return:
+ * 	The place of the key in the bucket if it's there, and otherwise - the place
+ * 	where it should be inserted.
+ */
+static int findPlace(DayBucket* bucket, int hour, TechnionFaculty faculty,
+int room_id, bool* found) {
+	assert(bucket && found);
+	int low = 0, high = bucket->size;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(compareEntry(&(bucket->entries[middle]), hour, faculty, room_id) < 0)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*found = ((low < bucket->size) &&
+	(compareEntry(&(bucket->entries[low]), hour, faculty, room_id) == 0));
+	return low;
+}
+
+/*
+ * A static function that grows the wheel until it covers a certain day, or
+ * until it has MAX_DAYS slots. The buckets are moved to their slots in the new
+ * wheel, and the far days it now covers are moved into it.
+ * #return:
+ * 	false - if an allocation has failed (the wheel is left unchanged),
+ * 	true - otherwise.
+ */
+static bool growWheel(Calendar calendar, int day) {
+	assert(calendar && (day >= calendar->today));
+	int new_capacity = calendar->capacity;
+	while((new_capacity < MAX_DAYS) && (day - calendar->today >= new_capacity))
+		new_capacity *= GROWTH_FACTOR;
+	CHECK_VALID((new_capacity > calendar->capacity), true)
+	DayBucket* new_buckets = calloc(new_capacity, sizeof(*new_buckets));
+	CHECK_VALID(new_buckets, false)
+	for(int curr_day = calendar->today;
+	curr_day < calendar->today + calendar->capacity; curr_day++)
+		new_buckets[curr_day & (new_capacity-1)] =
+		calendar->buckets[DAY_SLOT(calendar, curr_day)];
+	free(calendar->buckets);
+	calendar->buckets = new_buckets;
+	calendar->capacity = new_capacity;
+	drainFarDays(calendar);
+	return true;
+}
+
+/*
+ * A static function that makes room for more entries in a bucket.
+ * #return:
+ * 	false - if an allocation has failed (the bucket is left unchanged),
+ * 	true - otherwise.
+ */
+static bool growBucket(DayBucket* bucket) {
+	assert(bucket);
+	int new_capacity = (bucket->capacity == 0) ? (INITIAL_BUCKET_SIZE) :
+	(bucket->capacity*GROWTH_FACTOR);
+	CalendarEntry* new_entries = realloc(bucket->entries,
+	new_capacity*sizeof(*new_entries));
+	CHECK_VALID(new_entries, false)
+	bucket->entries = new_entries;
+	bucket->capacity = new_capacity;
+	return true;
+}
+
+/*
+ * A static function that finds the place of a day in the far days array
+ * (binary search).
+ * 	$found: Address where we store whether the day is in the array.
+ * #return:
+ * 	The place of the day if it's in the array, and otherwise - the place where
+ * 	it should be inserted.
+ */
+static int findFarDay(Calendar calendar, int day, bool* found) {
+	assert(calendar && found);
+	int low = 0, high = calendar->far_amount;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(calendar->far_days[middle].day < day)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*found = ((low < calendar->far_amount) &&
+	(calendar->far_days[low].day == day));
+	return low;
+}
+
+/*
+ * A static function that finds the bucket of a day: its slot in the wheel, or
+ * its far day.
+ * #return:
+ * 	NULL if the day passed or it's a far day without reservations,
+ * 	and the day's bucket otherwise.
+ */
+static DayBucket* findBucket(Calendar calendar, int day) {
+	assert(calendar);
+	CHECK_VALID((day >= calendar->today), NULL)
+	if(isCovered(calendar, day))
+		return &(calendar->buckets[DAY_SLOT(calendar, day)]);
+	bool found = false;
+	int place = findFarDay(calendar, day, &found);
+	CHECK_VALID(found, NULL)
+	return &(calendar->far_days[place].bucket);
+}
+
+/*
+ * A static function that adds an empty far day to its place in the array.
+ * #return:
+ * 	NULL if an allocation has failed (the array is left unchanged),
+ * 	and the far day's bucket otherwise.
+ */
+static DayBucket* addFarDay(Calendar calendar, int day) {
+	assert(calendar && !isCovered(calendar, day));
+	if(calendar->far_amount == calendar->far_capacity) {
+		int new_capacity = (calendar->far_capacity == 0) ?
+		(INITIAL_BUCKET_SIZE) : (calendar->far_capacity*GROWTH_FACTOR);
+		FarDay* new_far_days = realloc(calendar->far_days,
+		new_capacity*sizeof(*new_far_days));
+		CHECK_VALID(new_far_days, NULL)
+		calendar->far_days = new_far_days;
+		calendar->far_capacity = new_capacity;
+	}
+	bool found = false;
+	int place = findFarDay(calendar, day, &found);
+	assert(!found);
+	memmove(&(calendar->far_days[place+1]), &(calendar->far_days[place]),
+	(calendar->far_amount - place)*sizeof(*(calendar->far_days)));
+	(calendar->far_amount)++;
+	FarDay* far_day = &(calendar->far_days[place]);
+	far_day->day = day;
+	far_day->bucket.entries = NULL;
+	far_day->bucket.capacity = 0;
+	far_day->bucket.size = 0;
+	return &(far_day->bucket);
+}
+
+/*
+ * A static function that removes a far day (with its bucket) from the array.
+ */
+static void removeFarDay(Calendar calendar, int place) {
+	assert(calendar && (place >= 0) && (place < calendar->far_amount));
+	free(calendar->far_days[place].bucket.entries);
+	memmove(&(calendar->far_days[place]), &(calendar->far_days[place+1]),
+	(calendar->far_amount - place - 1)*sizeof(*(calendar->far_days)));
+	(calendar->far_amount)--;
+}
+
+/*
+ * A static function that moves the buckets of the far days that the wheel
+ * covers into their (empty) slots. The buckets are moved as they are, so
+ * nothing is allocated.
+ */
+static void drainFarDays(Calendar calendar) {
+	assert(calendar);
+	int drained = 0;
+	while((drained < calendar->far_amount) &&
+	isCovered(calendar, calendar->far_days[drained].day)) {
+		FarDay* far_day = &(calendar->far_days[drained++]);
+		DayBucket* slot = &(calendar->buckets[DAY_SLOT(calendar, far_day->day)]);
+		assert(slot->size == 0);
+		free(slot->entries);
+		*slot = far_day->bucket;
+	}
+	if(drained == 0)
+		return;
+	memmove(calendar->far_days, &(calendar->far_days[drained]),
+	(calendar->far_amount - drained)*sizeof(*(calendar->far_days)));
+	calendar->far_amount -= drained;
+}
+
+Calendar calendarCreate(int today) {
+	CHECK_VALID((today >= 0), NULL)
+	Calendar calendar = malloc(sizeof(*calendar));
+	CHECK_VALID(calendar, NULL)
+	calendar->buckets = calloc(INITIAL_DAYS, sizeof(*(calendar->buckets)));
+	if(!(calendar->buckets)) {
+		free(calendar);
+		return NULL;
+	}
+	calendar->capacity = INITIAL_DAYS;
+	calendar->today = today;
+	//The far days array is allocated when the first far day is added.
+	calendar->far_days = NULL;
+	calendar->far_amount = 0;
+	calendar->far_capacity = 0;
+	return calendar;
+}
+
+CalendarResult calendarDestroy(Calendar calendar) {
+	CHECK_VALID(calendar, CALENDAR_NULL_PARAMETER)
+	for(int i=0; i<calendar->capacity; i++)
+		free(calendar->buckets[i].entries);
+	free(calendar->buckets);
+	for(int i=0; i<calendar->far_amount; i++)
+		free(calendar->far_days[i].bucket.entries);
+	free(calendar->far_days);
+	free(calendar);
+	return CALENDAR_SUCCESS;
+}
+
+CalendarResult calendarAdd(Calendar calendar, Reservation reservation,
+Room room, struct Company_t* company) {
+	CHECK_VALID(calendar && reservation, CALENDAR_NULL_PARAMETER)
+	CHECK_VALID(room && company, CALENDAR_NULL_PARAMETER)
+	int day = reservationGetDay(reservation), room_id = 0,
+	hour = reservationGetHour(reservation);
+	TechnionFaculty faculty = reservationGetFaculty(reservation);
+	reservationGetRoomId(reservation, &room_id);
+	CHECK_VALID((day >= calendar->today), CALENDAR_INVALID_PARAMETER)
+	if(!isCovered(calendar, day))
+		CHECK_VALID(growWheel(calendar, day), CALENDAR_OUT_OF_MEMORY)
+	DayBucket* bucket = findBucket(calendar, day);
+	if(!bucket) {
+		//A far day's first reservation.
+		bucket = addFarDay(calendar, day);
+		CHECK_VALID(bucket, CALENDAR_OUT_OF_MEMORY)
+	}
+	bool found = false;
+	int place = findPlace(bucket, hour, faculty, room_id, &found);
+	CHECK_VALID(!found, CALENDAR_RESERVATION_EXISTS)
+	if((bucket->size == bucket->capacity) && !growBucket(bucket)) {
+		if(bucket->size == 0)
+			//The far day was added for this reservation.
+			removeFarDay(calendar, findFarDay(calendar, day, &found));
+		return CALENDAR_OUT_OF_MEMORY;
+	}
+	memmove(&(bucket->entries[place+1]), &(bucket->entries[place]),
+	(bucket->size - place)*sizeof(*(bucket->entries)));
+	CalendarEntry* entry = &(bucket->entries[place]);
+	entry->hour = hour;
+	entry->faculty = faculty;
+	entry->room_id = room_id;
+	entry->reservation = reservation;
+	entry->room = room;
+	entry->company = company;
+	(bucket->size)++;
+	return CALENDAR_SUCCESS;
+}
+
+CalendarResult calendarRemove(Calendar calendar, Reservation reservation) {
+	CHECK_VALID(calendar && reservation, CALENDAR_NULL_PARAMETER)
+	int day = reservationGetDay(reservation), room_id = 0;
+	reservationGetRoomId(reservation, &room_id);
+	DayBucket* bucket = findBucket(calendar, day);
+	CHECK_VALID(bucket, CALENDAR_RESERVATION_DOES_NOT_EXIST)
+	bool found = false;
+	int place = findPlace(bucket, reservationGetHour(reservation),
+	reservationGetFaculty(reservation), room_id, &found);
+	CHECK_VALID((found && (bucket->entries[place].reservation == reservation)),
+	CALENDAR_RESERVATION_DOES_NOT_EXIST)
+	memmove(&(bucket->entries[place]), &(bucket->entries[place+1]),
+	(bucket->size - place - 1)*sizeof(*(bucket->entries)));
+	(bucket->size)--;
+	if((bucket->size == 0) && !isCovered(calendar, day))
+		//A far day without reservations isn't kept.
+		removeFarDay(calendar, findFarDay(calendar, day, &found));
+	return CALENDAR_SUCCESS;
+}
+
+int calendarDayReservations(Calendar calendar, int day) {
+	CHECK_VALID(calendar, 0)
+	DayBucket* bucket = findBucket(calendar, day);
+	CHECK_VALID(bucket, 0)
+	return bucket->size;
+}
+
+Reservation calendarGetReservation(Calendar calendar, int day, int index,
+Room* room, struct Company_t** company) {
+	CHECK_VALID(calendar, NULL)
+	DayBucket* bucket = findBucket(calendar, day);
+	CHECK_VALID(bucket, NULL)
+	CHECK_VALID(((index >= 0) && (index < bucket->size)), NULL)
+	INIT_IF_EXISTS(room, bucket->entries[index].room);
+	INIT_IF_EXISTS(company, bucket->entries[index].company);
+	return bucket->entries[index].reservation;
+}
+
+CalendarResult calendarNextDay(Calendar calendar) {
+	CHECK_VALID(calendar, CALENDAR_NULL_PARAMETER)
+	DayBucket* bucket = &(calendar->buckets[DAY_SLOT(calendar,
+	calendar->today)]);
+	//The slot will serve the day that enters the wheel, so we empty it.
+	free(bucket->entries);
+	bucket->entries = NULL;
+	bucket->capacity = 0;
+	bucket->size = 0;
+	(calendar->today)++;
+	//The wheel covers one more day, which might have been a far day.
+	drainFarDays(calendar);
+	return CALENDAR_SUCCESS;
+}
@@ -0,0 +1,115 @@
+#ifndef CALENDAR_H_
+#define CALENDAR_H_
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "Reservation.h"
+#include "Room.h"
+#include "mtm_ex3.h"
+
+typedef struct Calendar_t *Calendar; //Name of the ADT.
+
+//The company ADT (declared in Company.h, which includes this file).
+struct Company_t;
+
+typedef enum {
+	//The calendar's errors:
+	CALENDAR_SUCCESS,
+	CALENDAR_NULL_PARAMETER,
+	CALENDAR_INVALID_PARAMETER,
+	CALENDAR_OUT_OF_MEMORY,
+	CALENDAR_RESERVATION_EXISTS,
+	CALENDAR_RESERVATION_DOES_NOT_EXIST,
+} CalendarResult;
+
+/*
+ * Allocates a new, empty calendar.
+ * The calendar holds a bucket for every day (from the current day on) with the
+ * reservations of that day, sorted by hour, then by the faculty of the room and
+ * then by the room's id - the order in which a day's reservations are reported.
+ * The buckets are kept in a wheel: the bucket of a day is found by its day
+ * number, and the wheel grows when a reservation is made for a far away day,
+ * up to a fixed amount of days. The buckets of the days after that are kept
+ * aside, and are moved into the wheel as the days pass.
+ * NOTE: The calendar does not own the reservations, rooms and companies it
+ * points to. A reservation has to be removed from the calendar before it's
+ * deallocated.
+ * 	$today: The current day. Reservations can be added from this day on.
+ * #return:
+ * 	NULL if an allocation has failed or the day is negative,
+ * 	and a new calendar otherwise.
+ */
+Calendar calendarCreate(int today);
+
+/*
+ * Deallocates a calendar. The reservations, rooms and companies the calendar
+ * points to are not affected.
+ * #return:
+ * 	CALENDAR_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	CALENDAR_SUCCESS - Otherwise.
+ */
+CalendarResult calendarDestroy(Calendar calendar);
+
+/*
+ * Adds a reservation to the bucket of its day.
+ * 	$reservation: The reservation. Its day, hour, faculty and room id are used
+ * 	to find its place in the calendar.
+ * 	$room: The room the reservation was made for.
+ * 	$company: The company that owns the room.
+ * #return:
+ * 	CALENDAR_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	CALENDAR_INVALID_PARAMETER - If the reservation is for a day that passed,
+ * 	CALENDAR_RESERVATION_EXISTS - If the room already has a reservation in the
+ * 	calendar at the same time,
+ * 	CALENDAR_OUT_OF_MEMORY - If an allocation has failed,
+ * 	CALENDAR_SUCCESS - Otherwise.
+ */
+CalendarResult calendarAdd(Calendar calendar, Reservation reservation,
+Room room, struct Company_t* company);
+
+/*
+ * Removes a reservation from the calendar.
+ * #return:
+ * 	CALENDAR_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	CALENDAR_RESERVATION_DOES_NOT_EXIST - If the reservation isn't in the
+ * 	calendar,
+ * 	CALENDAR_SUCCESS - Otherwise.
+ */
+CalendarResult calendarRemove(Calendar calendar, Reservation reservation);
+
+/*
+ * Returns the amount of reservations that are scheduled for a certain day.
+ * 	$day: The day (counted from the system's first day).
+ * #return:
+ * 	0 - If a NULL pointer was sent or there are no reservations for that day,
+ * 	and the amount of reservations for that day otherwise.
+ */
+int calendarDayReservations(Calendar calendar, int day);
+
+/*
+ * Gets a reservation of a certain day by its place in the day's order.
+ * 	$day: The day (counted from the system's first day).
+ * 	$index: The place of the reservation in the day's order, starting from 0.
+ * 	$room: Address where the reservation's room will be stored. Can be sent as
+ * 	NULL if the room is not needed.
+ * 	$company: Address where the company that owns the room will be stored. Can
+ * 	be sent as NULL if the company is not needed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent or there's no such reservation,
+ * 	and the reservation otherwise.
+ */
+Reservation calendarGetReservation(Calendar calendar, int day, int index,
+Room* room, struct Company_t** company);
+
+/*
+ * Discards the bucket of the current day and moves the calendar to the next
+ * day. The reservations of the discarded bucket are not affected.
+ * #return:
+ * 	CALENDAR_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	CALENDAR_SUCCESS - Otherwise.
+ */
+CalendarResult calendarNextDay(Calendar calendar);
+
+#endif /* CALENDAR_H_ */
@@ -0,0 +1,195 @@
+#include <limits.h>
+#include "Checkpoint.h"
+
+/*
+ * Implementation of the Checkpoint ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "Checkpoint".
+ */
+struct Checkpoint_t {
+	FILE* file; //The image's file.
+	CheckpointResult result; //The first error, or CHECKPOINT_SUCCESS.
+	char* string; //The buffer of the last string that was read.
+	int string_capacity; //The size of the string buffer.
+};
+
+//The mark in the beginning of every image.
+#define CHECKPOINT_MAGIC "ESCP"
+
+//The length of the mark.
+#define MAGIC_LENGTH 4
+
+//The version of the image's format. Changes whenever the format changes.
+#define CHECKPOINT_VERSION 1
+
+//The amount of bytes a number takes in the image.
+#define INT_BYTES 4
+
+//The amount of bits in a byte.
+#define BYTE_BITS 8
+
+//The initial size of the string buffer.
+#define INITIAL_STRING_CAPACITY 256
+
+//The longest string an image can hold (longer ones mean the file is broken).
+#define MAX_STRING_LENGTH (1 << 20)
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+static void setError(Checkpoint checkpoint, CheckpointResult error);
+static void writeBytes(Checkpoint checkpoint, const void* bytes, size_t size);
+static void readBytes(Checkpoint checkpoint, void* bytes, size_t size);
+
+/*
+ * A static function that keeps an error, unless an error already occurred.
+ */
+static void setError(Checkpoint checkpoint, CheckpointResult error) {
+	assert(checkpoint);
+	if(checkpoint->result == CHECKPOINT_SUCCESS)
+		checkpoint->result = error;
+}
+
+/*
+ * A static function that writes bytes to the file (if no error occurred).
+ */
+static void writeBytes(Checkpoint checkpoint, const void* bytes, size_t size) {
+	assert(checkpoint && bytes);
+	if(checkpoint->result != CHECKPOINT_SUCCESS)
+		return;
+	if(fwrite(bytes, 1, size, checkpoint->file) != size)
+		setError(checkpoint, CHECKPOINT_FILE_ERROR);
+}
+
+/*
+ * A static function that reads bytes from the file (if no error occurred).
+ * If the file ends before all the bytes are read, the image is invalid.
+ */
+static void readBytes(Checkpoint checkpoint, void* bytes, size_t size) {
+	assert(checkpoint && bytes);
+	if(checkpoint->result != CHECKPOINT_SUCCESS)
+		return;
+	if(fread(bytes, 1, size, checkpoint->file) != size)
+		setError(checkpoint, ferror(checkpoint->file) ?
+		CHECKPOINT_FILE_ERROR : CHECKPOINT_INVALID_FORMAT);
+}
+
+Checkpoint checkpointCreate(FILE* file) {
+	CHECK_VALID(file, NULL)
+	Checkpoint checkpoint = malloc(sizeof(*checkpoint));
+	CHECK_VALID(checkpoint, NULL)
+	checkpoint->string = malloc(INITIAL_STRING_CAPACITY);
+	if(!(checkpoint->string)) {
+		free(checkpoint);
+		return NULL;
+	}
+	checkpoint->string[0] = '\0';
+	checkpoint->string_capacity = INITIAL_STRING_CAPACITY;
+	checkpoint->file = file;
+	checkpoint->result = CHECKPOINT_SUCCESS;
+	return checkpoint;
+}
+
+CheckpointResult checkpointDestroy(Checkpoint checkpoint) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	free(checkpoint->string);
+	free(checkpoint);
+	return CHECKPOINT_SUCCESS;
+}
+
+CheckpointResult checkpointGetResult(Checkpoint checkpoint) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	return checkpoint->result;
+}
+
+CheckpointResult checkpointInvalidate(Checkpoint checkpoint) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	setError(checkpoint, CHECKPOINT_INVALID_FORMAT);
+	return CHECKPOINT_SUCCESS;
+}
+
+CheckpointResult checkpointWriteHeader(Checkpoint checkpoint) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	writeBytes(checkpoint, CHECKPOINT_MAGIC, MAGIC_LENGTH);
+	return checkpointWriteInt(checkpoint, CHECKPOINT_VERSION);
+}
+
+CheckpointResult checkpointReadHeader(Checkpoint checkpoint) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	char magic[MAGIC_LENGTH] = {0};
+	int version = 0;
+	readBytes(checkpoint, magic, MAGIC_LENGTH);
+	checkpointReadInt(checkpoint, &version);
+	if((memcmp(magic, CHECKPOINT_MAGIC, MAGIC_LENGTH) != 0) ||
+	(version != CHECKPOINT_VERSION))
+		setError(checkpoint, CHECKPOINT_INVALID_FORMAT);
+	return checkpoint->result;
+}
+
+CheckpointResult checkpointWriteInt(Checkpoint checkpoint, int number) {
+	CHECK_VALID(checkpoint, CHECKPOINT_NULL_PARAMETER)
+	unsigned char bytes[INT_BYTES];
+	unsigned long value = (unsigned long)(unsigned int)number;
+	for(int i=0; i<INT_BYTES; i++)
+		bytes[i] = (unsigned char)((value >> (i*BYTE_BITS)) & UCHAR_MAX);
+	writeBytes(checkpoint, bytes, INT_BYTES);
+	return checkpoint->result;
+}
+
+CheckpointResult checkpointReadInt(Checkpoint checkpoint, int* number) {
+	CHECK_VALID(checkpoint && number, CHECKPOINT_NULL_PARAMETER)
+	unsigned char bytes[INT_BYTES] = {0};
+	readBytes(checkpoint, bytes, INT_BYTES);
+	unsigned long value = 0;
+	for(int i=0; i<INT_BYTES; i++)
+		value |= ((unsigned long)bytes[i]) << (i*BYTE_BITS);
+	//The bytes hold the number in two's complement.
+	*number = (value > (unsigned long)INT_MAX) ?
+	(-(int)(0xFFFFFFFFul - value) - 1) : ((int)value);
+	if(checkpoint->result != CHECKPOINT_SUCCESS)
+		*number = 0;
+	return checkpoint->result;
+}
+
+CheckpointResult checkpointWriteString(Checkpoint checkpoint, char* string) {
+	CHECK_VALID(checkpoint && string, CHECKPOINT_NULL_PARAMETER)
+	size_t length = strlen(string);
+	if(length > MAX_STRING_LENGTH) {
+		setError(checkpoint, CHECKPOINT_INVALID_FORMAT);
+		return checkpoint->result;
+	}
+	checkpointWriteInt(checkpoint, (int)length);
+	writeBytes(checkpoint, string, length);
+	return checkpoint->result;
+}
+
+CheckpointResult checkpointReadString(Checkpoint checkpoint, char** string) {
+	CHECK_VALID(checkpoint && string, CHECKPOINT_NULL_PARAMETER)
+	int length = 0;
+	checkpoint->string[0] = '\0';
+	*string = checkpoint->string;
+	checkpointReadInt(checkpoint, &length);
+	if((length < 0) || (length > MAX_STRING_LENGTH))
+		setError(checkpoint, CHECKPOINT_INVALID_FORMAT);
+	CHECK_VALID((checkpoint->result == CHECKPOINT_SUCCESS),
+	checkpoint->result)
+	if(length+1 > checkpoint->string_capacity) {
+		char* new_string = realloc(checkpoint->string, length+1);
+		if(!new_string) {
+			setError(checkpoint, CHECKPOINT_OUT_OF_MEMORY);
+			return checkpoint->result;
+		}
+		checkpoint->string = new_string;
+		checkpoint->string_capacity = length+1;
+		*string = checkpoint->string;
+	}
+	readBytes(checkpoint, checkpoint->string, length);
+	checkpoint->string[(checkpoint->result == CHECKPOINT_SUCCESS) ? length : 0]
+	= '\0';
+	return checkpoint->result;
+}
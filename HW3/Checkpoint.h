@@ -0,0 +1,118 @@
+#ifndef CHECKPOINT_H_
+#define CHECKPOINT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+typedef struct Checkpoint_t *Checkpoint; //Name of the ADT.
+
+typedef enum {
+	//The checkpoint's errors:
+	CHECKPOINT_SUCCESS,
+	CHECKPOINT_NULL_PARAMETER,
+	CHECKPOINT_OUT_OF_MEMORY,
+	CHECKPOINT_FILE_ERROR,
+	CHECKPOINT_INVALID_FORMAT,
+} CheckpointResult;
+
+/*
+ * Allocates a new checkpoint over a binary file stream.
+ * A checkpoint writes (or reads) a system's image as a sequence of numbers and
+ * strings: numbers are stored as 4 little-endian bytes, and strings as their
+ * length followed by their characters. The first error that occurs is kept,
+ * and every operation after it does nothing, so a whole image can be written
+ * or read before checking the result once.
+ * NOTE: The checkpoint doesn't close the file.
+ * 	$file: A file stream, opened for binary writing or reading.
+ * #return:
+ * 	NULL if a NULL pointer was sent or an allocation has failed,
+ * 	and a new checkpoint otherwise.
+ */
+Checkpoint checkpointCreate(FILE* file);
+
+/*
+ * Deallocates a checkpoint.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	CHECKPOINT_SUCCESS - Otherwise.
+ */
+CheckpointResult checkpointDestroy(Checkpoint checkpoint);
+
+/*
+ * Returns the first error that occurred in the checkpoint.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	CHECKPOINT_SUCCESS - If no error occurred,
+ * 	and the first error otherwise.
+ */
+CheckpointResult checkpointGetResult(Checkpoint checkpoint);
+
+/*
+ * Marks the checkpoint as invalid (used by a reader that found a value that
+ * makes no sense). Does nothing if an error already occurred.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	CHECKPOINT_SUCCESS - Otherwise.
+ */
+CheckpointResult checkpointInvalidate(Checkpoint checkpoint);
+
+/*
+ * Writes the header of an image: a mark that identifies the format, and its
+ * version.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise.
+ */
+CheckpointResult checkpointWriteHeader(Checkpoint checkpoint);
+
+/*
+ * Reads the header of an image, and checks that it's of a known format and
+ * version.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise (CHECKPOINT_INVALID_FORMAT if the
+ * 	header isn't one this checkpoint writes).
+ */
+CheckpointResult checkpointReadHeader(Checkpoint checkpoint);
+
+/*
+ * Writes a number.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise.
+ */
+CheckpointResult checkpointWriteInt(Checkpoint checkpoint, int number);
+
+/*
+ * Reads a number.
+ * 	$number: Address where the number will be stored. It's set to 0 if the
+ * 	number couldn't be read.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise.
+ */
+CheckpointResult checkpointReadInt(Checkpoint checkpoint, int* number);
+
+/*
+ * Writes a string.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise.
+ */
+CheckpointResult checkpointWriteString(Checkpoint checkpoint, char* string);
+
+/*
+ * Reads a string.
+ * 	$string: Address where the string will be stored. The string is kept in the
+ * 	checkpoint's buffer, and is valid until the next string is read. It's set
+ * 	to an empty string if the string couldn't be read.
+ * #return:
+ * 	CHECKPOINT_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	and the checkpoint's result otherwise.
+ */
+CheckpointResult checkpointReadString(Checkpoint checkpoint, char** string);
+
+#endif /* CHECKPOINT_H_ */
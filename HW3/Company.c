@@ -1,15 +1,20 @@
 #include "Company.h"
 
 struct Company_t {
-	char* email; //The company's email.
+	int email_id; //The id of the company's email (in the system's index).
 	TechnionFaculty faculty; //The faculty to which this company belongs.
-	Set rooms; //Set of rooms that belong to this company.
+	Room* rooms; //The rooms that belong to this company, sorted by id.
+	int rooms_amount; //The amount of rooms in the array.
+	int rooms_capacity; //The amount of rooms the array can hold.
+	int iterator; //The place of the current room in the internal iteration.
+	int reservations_amount; //The amount of reservations in all the rooms.
 };
 
-//A valid email must contain exactly one '@'
-#define EMAIL_SIGN '@'
+//The initial amount of rooms the array can hold.
+#define INITIAL_ROOMS 4
 
-#define NOT_INITIALIZED -1
+//The array grows by this factor each time.
+#define GROWTH_FACTOR 2
 
 /*
  * A macro for checking the validity of a boolean condition.
@@ -26,73 +31,82 @@ struct Company_t {
 #define INIT_IF_EXISTS(ptr, value) \
 	if(ptr) { (*ptr) = value; }
 
-static bool isLegalEmail(char* email);
-static SetElement copyRoom(SetElement room);
-static void freeRoom(SetElement room);
-static int roomsCompare(SetElement room1, SetElement room2);
+static int findRoom(Company company, int id, bool* found);
+static bool growRooms(Company company);
+static bool insertRoom(Company company, Room room);
 
 /*
- * A static function used in order to check if the escaper's
- * email is valid by checking if it has the char '@' only one time in it
+ * A static function that finds the place of a room id in the company's rooms
+ * array (binary search).
+ * 	$found: Address where we store whether the company has a room with the id.
+ * #return:
+ * 	The place of the room if it's in the array, and otherwise - the place
+ * 	where it should be inserted.
  */
-static bool isLegalEmail(char* email){
-	assert(email);
-	int i=0, count=0;
-	while(email[i])
-		if(email[i++] == EMAIL_SIGN)
-			count++;
-	return (count == 1);
-}
-
-/*
- * A static function that defines the company's set's copy function.
- * The copy function is required to get an element of type SetElement, and
- * return an element of the same type.
- * The copy function is defined as follows: The set's elements are of the type
- * "Room", so we cast the element to be its real type, and then return the
- * result of the room's copy function.
- */
-static SetElement copyRoom(SetElement room){
-	return roomCopy((Room)(room));
+static int findRoom(Company company, int id, bool* found) {
+	assert(company && found);
+	int low = 0, high = company->rooms_amount, middle_id = 0;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		roomGetId(company->rooms[middle], &middle_id);
+		if(middle_id < id)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*found = false;
+	if(low < company->rooms_amount) {
+		roomGetId(company->rooms[low], &middle_id);
+		*found = (middle_id == id);
+	}
+	return low;
 }
 
 /*
- * A static function that defines the company's set's free function.
- * The free function is required to get an element of type SetElement, and
- * return void. The free function is defined as follows: the set's elements are
- * of the type "Room", so we cast the element to be its real type, and then
- * use the room's destroy function.
+ * A static function that makes room for more rooms in the company's array.
+ * #return:
+ * 	false - if an allocation has failed (the array is left unchanged),
+ * 	true - otherwise.
  */
-static void freeRoom(SetElement room) {
-	roomDestroy((Room)(room));
+static bool growRooms(Company company) {
+	assert(company);
+	int new_capacity = (company->rooms_capacity == 0) ? (INITIAL_ROOMS) :
+	(company->rooms_capacity*GROWTH_FACTOR);
+	Room* new_rooms = realloc(company->rooms, new_capacity*sizeof(*new_rooms));
+	CHECK_VALID(new_rooms, false)
+	company->rooms = new_rooms;
+	company->rooms_capacity = new_capacity;
+	return true;
 }
 
 /*
- * A static function that defines the company's set's compare function.
- * The compare function is required to get two elements of type SetElement, and
- * return an integer.
- * The compare function is defined as follows: the set's elements are of the
- * type "Room", so we cast the elements to be their real type. Then, we consider
- * the rooms' ids, and return the subtraction between the two rooms' ids.
+ * A static function that adds a room to its place in the company's array. The
+ * company takes ownership of the room, so the room in the array is the same
+ * room the room index points to.
+ * #return:
+ * 	false - if an allocation has failed or the company already has a room with
+ * 	the same id (the array is left unchanged),
+ * 	true - otherwise.
  */
-static int roomsCompare(SetElement room1, SetElement room2) {
-    int id1=0, id2=0;
-    roomGetId((Room)room1, &id1);
-    roomGetId((Room)room2, &id2);
-    return id1-id2;
+static bool insertRoom(Company company, Room room) {
+	assert(company && room);
+	int id = 0;
+	bool found = false;
+	roomGetId(room, &id);
+	int place = findRoom(company, id, &found);
+	CHECK_VALID(!found, false)
+	if(company->rooms_amount == company->rooms_capacity)
+		CHECK_VALID(growRooms(company), false)
+	memmove(&(company->rooms[place+1]), &(company->rooms[place]),
+	(company->rooms_amount - place)*sizeof(*(company->rooms)));
+	company->rooms[place] = room;
+	(company->rooms_amount)++;
+	return true;
 }
 
-Company companyCreate(CompanyResult* result, char* email,
+Company companyCreate(CompanyResult* result, int email_id,
 TechnionFaculty faculty) {
-	if(!email) {
-		INIT_IF_EXISTS(result, COMPANY_NULL_PARAMETER);
-		return NULL;
-	}
-	if(!isLegalEmail(email)) {
-		INIT_IF_EXISTS(result, COMPANY_INVALID_PARAMETER);
-		return NULL;
-	}
-	if(!(faculty>=0 && faculty<UNKNOWN)) {
+	if(!(email_id>=0 && faculty>=0 && faculty<UNKNOWN)) {
 		INIT_IF_EXISTS(result, COMPANY_INVALID_PARAMETER);
 		return NULL;
 	}
@@ -102,20 +116,13 @@ TechnionFaculty faculty) {
 		INIT_IF_EXISTS(result, COMPANY_OUT_OF_MEMORY);
 		return NULL;
 	}
-	company->email = malloc(strlen(email)+1);
-	if(!(company->email)) {
-		free(company);
-		INIT_IF_EXISTS(result, COMPANY_OUT_OF_MEMORY);
-		return NULL;
-	}
-	strcpy(company->email, email);
-	company->rooms = setCreate(copyRoom, freeRoom, roomsCompare);
-	if(!(company->rooms)) {
-		free(company->email);
-		free(company);
-		INIT_IF_EXISTS(result, COMPANY_OUT_OF_MEMORY);
-		return NULL;
-	}
+	//The array is allocated when the first room is added.
+	company->rooms = NULL;
+	company->rooms_amount = 0;
+	company->rooms_capacity = 0;
+	company->iterator = 0;
+	company->reservations_amount = 0;
+	company->email_id = email_id;
 	company->faculty = faculty;
 	INIT_IF_EXISTS(result, COMPANY_SUCCESS);
 	return company;
@@ -123,8 +130,9 @@ TechnionFaculty faculty) {
 
 CompanyResult companyDestroy(Company company){
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
-	setDestroy(company->rooms);
-	free(company->email);
+	for(int i=0; i<company->rooms_amount; i++)
+		roomDestroy(company->rooms[i]);
+	free(company->rooms);
 	free(company);
 	return COMPANY_SUCCESS;
 }
@@ -132,22 +140,25 @@ CompanyResult companyDestroy(Company company){
 Company companyCopy(Company company){
 	CHECK_VALID(company, NULL)
 	Company company_copy = companyCreate
-	(NULL, company->email, company->faculty);
+	(NULL, company->email_id, company->faculty);
 	CHECK_VALID(company_copy, NULL)
-	setDestroy(company_copy->rooms);
-	company_copy->rooms = setCopy(company->rooms);
-	if(!company_copy->rooms) {
-		free(company_copy);
-		return NULL;
+	//The company owns its rooms, so we copy them one by one.
+	for(int i=0; i<company->rooms_amount; i++) {
+		Room room_copy = roomCopy(company->rooms[i]);
+		if((!room_copy) || (!insertRoom(company_copy, room_copy))) {
+			roomDestroy(room_copy);
+			companyDestroy(company_copy);
+			return NULL;
+		}
 	}
-	company_copy->faculty = company->faculty;
+	company_copy->reservations_amount = company->reservations_amount;
 	return company_copy;
 }
 
-CompanyResult companyGetEmail(Company company, char** email){
+CompanyResult companyGetEmailId(Company company, int* email_id){
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
-	CHECK_VALID(email, COMPANY_NULL_PARAMETER)
-	*email = company->email;
+	CHECK_VALID(email_id, COMPANY_NULL_PARAMETER)
+	*email_id = company->email_id;
 	return COMPANY_SUCCESS;
 }
 
@@ -162,151 +173,149 @@ CompanyResult companyGetFaculty(Company company, TechnionFaculty* faculty){
 int companyEarns(Company company) {
 	CHECK_VALID(company, 0)
 	int company_earns = 0, room_earns = 0;
-	SET_FOREACH(Room, room, company->rooms) {
-		roomEarns(room, &room_earns);
+	for(int i=0; i<company->rooms_amount; i++) {
+		roomEarns(company->rooms[i], &room_earns);
 		company_earns += room_earns;
 	}
 	return company_earns;
 }
 
-CompanyResult companyNewRoom(Company company, int id, int entry_fee,
-int recommended_people, int difficulty, char* working_hours) {
+CompanyResult companyNewRoom(Company company, RoomIndex index, int id,
+int entry_fee, int recommended_people, int difficulty, int open_time,
+int close_time) {
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
-	CHECK_VALID(working_hours, COMPANY_NULL_PARAMETER)
+	CHECK_VALID(index, COMPANY_NULL_PARAMETER)
 	RoomResult room_result;
 	Room room = roomCreate(&room_result, id, entry_fee, recommended_people,
-	difficulty, working_hours);
+	difficulty, open_time, close_time);
 	if(room_result != ROOM_SUCCESS)
 		//There are two possibilities for failure here. We return the correct
 		//error code.
 		return ((room_result == ROOM_OUT_OF_MEMORY) ?
 		(COMPANY_OUT_OF_MEMORY) : (COMPANY_INVALID_PARAMETER));
-	SetResult set_result = setAdd(company->rooms, room);
-	roomDestroy(room);
-	if(set_result != SET_SUCCESS)
+	RoomIndexResult index_result = roomIndexAdd(index, company->faculty, id,
+	room, company);
+	if(index_result != ROOM_INDEX_SUCCESS) {
 		//There are two possibilities for failure here. We return the correct
 		//error code.
-		return(set_result == SET_OUT_OF_MEMORY) ?
+		roomDestroy(room);
+		return(index_result == ROOM_INDEX_OUT_OF_MEMORY) ?
 		(COMPANY_OUT_OF_MEMORY) : (COMPANY_ROOM_ID_EXISTS);
+	}
+	if(!insertRoom(company, room)) {
+		//The index already says the id is new, so it's a memory problem.
+		roomIndexRemove(index, company->faculty, id);
+		roomDestroy(room);
+		return COMPANY_OUT_OF_MEMORY;
+	}
 	return COMPANY_SUCCESS;
 }
 
-CompanyResult companyRemoveRoom(Company company, int id){
+CompanyResult companyRemoveRoom(Company company, RoomIndex index, int id){
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
-	int target_id = 0;
-	SET_FOREACH(Room, remove_room, company->rooms) {
-		assert(remove_room);
-		roomGetId(remove_room, &target_id);
-		if(target_id == id) {
-			if(!roomHasReservations(remove_room)) {
-				setRemove(company->rooms, remove_room);
-				return COMPANY_SUCCESS;
-			}
-			else
-				return COMPANY_ROOM_HAS_RESERVATIONS;
-		}
+	CHECK_VALID(index, COMPANY_NULL_PARAMETER)
+	Company owner = NULL;
+	Room remove_room = roomIndexFind(index, company->faculty, id, &owner);
+	CHECK_VALID((remove_room && (owner == company)), COMPANY_ILLEGAL_ID)
+	CHECK_VALID(!roomHasReservations(remove_room),
+	COMPANY_ROOM_HAS_RESERVATIONS)
+	bool found = false;
+	int place = findRoom(company, id, &found);
+	assert(found && (company->rooms[place] == remove_room));
+	roomIndexRemove(index, company->faculty, id);
+	roomDestroy(remove_room);
+	memmove(&(company->rooms[place]), &(company->rooms[place+1]),
+	(company->rooms_amount - place - 1)*sizeof(*(company->rooms)));
+	(company->rooms_amount)--;
+	return COMPANY_SUCCESS;
+}
+
+CompanyResult companyIndexRooms(Company company, RoomIndex index) {
+	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
+	CHECK_VALID(index, COMPANY_NULL_PARAMETER)
+	int id = 0;
+	COMPANY_FOREACH(room, company) {
+		roomGetId(room, &id);
+		RoomIndexResult result = roomIndexAdd(index, company->faculty, id,
+		room, company);
+		if(result != ROOM_INDEX_SUCCESS)
+			return (result == ROOM_INDEX_OUT_OF_MEMORY) ?
+			(COMPANY_OUT_OF_MEMORY) : (COMPANY_ROOM_ID_EXISTS);
 	}
-	return COMPANY_ILLEGAL_ID;
+	return COMPANY_SUCCESS;
 }
 
-CompanyResult companyNextDay(Company company) {
+CompanyResult companyUnindexRooms(Company company, RoomIndex index) {
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
-	SET_FOREACH(Room, room, company->rooms) {
-		assert(room);
-		roomNextDay(room);
+	CHECK_VALID(index, COMPANY_NULL_PARAMETER)
+	int id = 0;
+	COMPANY_FOREACH(room, company) {
+		roomGetId(room, &id);
+		roomIndexRemove(index, company->faculty, id);
 	}
 	return COMPANY_SUCCESS;
 }
 
-int companyTodaysReservations(Company company) {
-	CHECK_VALID(company, 0)
-	int reservations_amount = 0;
-	SET_FOREACH(Room, room, company->rooms)
-		reservations_amount+=roomTodaysReservations(room);
-	return reservations_amount;
+CompanyResult companyScheduleReservations(Company company, Calendar calendar) {
+	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
+	CHECK_VALID(calendar, COMPANY_NULL_PARAMETER)
+	COMPANY_FOREACH(room, company) {
+		ROOM_FOREACH(reservation, room) {
+			if(calendarAdd(calendar, reservation, room, company) !=
+			CALENDAR_SUCCESS)
+				return COMPANY_OUT_OF_MEMORY;
+		}
+	}
+	return COMPANY_SUCCESS;
 }
 
 CompanyResult companyRoomsAmount(Company company, int* size) {
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
 	CHECK_VALID(size, COMPANY_NULL_PARAMETER)
-	*size = setGetSize(company->rooms);
+	*size = company->rooms_amount;
 	return COMPANY_SUCCESS;
 }
 
 CompanyResult companyGetRoom(Company company, Room* room, int id) {
 	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
 	CHECK_VALID(room, COMPANY_NULL_PARAMETER)
-	int target_id = 0;
-	SET_FOREACH(Room, target_room, company->rooms) {
-		assert(target_room);
-		roomGetId(target_room, &target_id);
-		if(target_id == id) {
-			*room = target_room;
-			return COMPANY_SUCCESS;
-		}
-	}
-	return COMPANY_ILLEGAL_ID;
+	bool found = false;
+	int place = findRoom(company, id, &found);
+	CHECK_VALID(found, COMPANY_ILLEGAL_ID)
+	*room = company->rooms[place];
+	return COMPANY_SUCCESS;
 }
 
 bool companyRoomsReserved(Company company) {
 	CHECK_VALID(company, false)
-	SET_FOREACH(Room, room, company->rooms) {
-		if(roomHasReservations(room))
-			return true;
-	}
-	return false;
+	return (__atomic_load_n(&(company->reservations_amount),
+	__ATOMIC_RELAXED) > 0);
+}
+
+CompanyResult companyUpdateReservations(Company company, int amount) {
+	CHECK_VALID(company, COMPANY_NULL_PARAMETER)
+	//Rooms of the same company can be reserved by a few threads at the same
+	//time, so the count is changed atomically.
+	int reservations = __atomic_load_n(&(company->reservations_amount),
+	__ATOMIC_RELAXED);
+	do {
+		CHECK_VALID((reservations + amount >= 0), COMPANY_INVALID_PARAMETER)
+	} while(!__atomic_compare_exchange_n(&(company->reservations_amount),
+	&reservations, reservations + amount, true, __ATOMIC_RELAXED,
+	__ATOMIC_RELAXED));
+	return COMPANY_SUCCESS;
 }
 
-Room companyLowestIdRoom(Company company, int* desired_id) {
+Room companyFirstRoom(Company company) {
 	CHECK_VALID(company, NULL)
-	CHECK_VALID(desired_id, NULL)
-	int min = NOT_INITIALIZED, id = NOT_INITIALIZED;
-	Room desired_room = setGetFirst(company->rooms);
-	roomGetId(desired_room, &min);
-	if(min == NOT_INITIALIZED) {
-		//No rooms in the company!
-		*desired_id = NOT_INITIALIZED;
-		return NULL;
-	}
-	SET_FOREACH(Room, room, company->rooms) {
-		//We find the room with the lowest id
-		roomGetId(room, &id);
-		if(id < min) {
-			desired_room = room;
-			min = id;
-		}
-	}
-	return desired_room;
+	company->iterator = 0;
+	CHECK_VALID((company->rooms_amount > 0), NULL)
+	return company->rooms[0];
 }
 
-Room companyNextRoom(Company company, int* id) {
+Room companyNextRoom(Company company) {
 	CHECK_VALID(company, NULL)
-	CHECK_VALID(id, NULL)
-	int min = NOT_INITIALIZED, curr_id = NOT_INITIALIZED, input_id = (*id);
-	Room desired_room = NULL;
-	SET_FOREACH(Room, room, company->rooms) {
-		roomGetId(room, &min);
-		if(min > input_id) {
-			//Found a room with an id that's bigger than the parameter id.
-			desired_room = room;
-			break;
-		}
-	}
-	if(!desired_room) {
-		//All the rooms in this company have an id that's smaller than the
-		//parameter id!
-		*id = NOT_INITIALIZED;
-		return NULL;
-	}
-	*id = min;
-	//There are acceptable rooms in this company
-	SET_FOREACH(Room, room, company->rooms) {
-		roomGetId(room, &curr_id);
-		if((curr_id > input_id) && (curr_id < min)) {
-			desired_room = room;
-			min = curr_id;
-		}
-	}
-	*id = min;
-	return desired_room;
+	CHECK_VALID((company->iterator+1 < company->rooms_amount), NULL)
+	(company->iterator)++;
+	return company->rooms[company->iterator];
 }
@@ -5,10 +5,11 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
-#include "set.h"
 #include "Room.h"
 #include "Escaper.h"
 #include "Reservation.h"
+#include "RoomIndex.h"
+#include "Calendar.h"
 #include "mtm_ex3.h"
 
 typedef struct Company_t *Company; //Name of the ADT.
@@ -31,13 +32,14 @@ typedef enum {
  * The required fields are:
  *  $result: Holds the result of the create function. Can be sent as NULL if
  *  the result of this function is not needed.
- * 	$email: The company's email. Must contain exactly one '@'.
+ * 	$email_id: The id of the company's email, in the system's email index. Must
+ * 	be non-negative.
  * 	$faculty: The faculty to which the company belongs.
  * #return:
  * 	NULL if one of the parameters is invalid or an allocation has failed,
  * 	and a new company otherwise. The new company has no rooms.
  */
-Company companyCreate(CompanyResult* result, char* email,
+Company companyCreate(CompanyResult* result, int email_id,
 TechnionFaculty faculty);
 /*
  * Deallocates a company. Clears all of the company's rooms' reservations and
@@ -59,13 +61,14 @@ CompanyResult companyDestroy(Company company);
 Company companyCopy(Company company);
 
 /*
- * Gets the company's email.
- * 	$email: Address where the email will be stored.
+ * Gets the id of the company's email (its email is found by the id in the
+ * system's email index).
+ * 	$email_id: Address where the id will be stored.
  * #return:
  * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent.
  * 	COMPANY_SUCCESS - Otherwise.
  */
-CompanyResult companyGetEmail(Company company, char** email);
+CompanyResult companyGetEmailId(Company company, int* email_id);
 
 /*
  * Gets the faculty to which the company belongs.
@@ -86,16 +89,19 @@ int companyEarns(Company company);
 
 /*
  * Adds a new room to a company's possession. The new room will have no
- * reservations yet. The required fields for initialization:
+ * reservations yet, and it's added to the room index under the company's
+ * faculty. The required fields for initialization:
+ * 	$index: The room index of the system. The faculty's rooms are looked up in
+ * 	it to make sure the id is unique.
  * 	$id: The room's id. Must be a positive number and unique (no rooms in this
- * 	company share this id).
+ * 	company's faculty share this id).
  * 	$entry_fee: The room's entry fee. Must be non-negative and divisible by 4.
  * 	$recommended_people: The amount of people recommended for the room. Must be
  * 	a positive number.
  * 	$difficulty: The room's difficulty. Must be between 1 and 10 (included).
- * 	$working_hours: The room's scheduled working hours. Received as a string of
- * 	the following format: "xx-yy". xx and yy must be between 0 and 23,
- * 	where yy>xx.
+ * 	$open_time: The hour when the room opens. Must be between 0 and 23.
+ * 	$close_time: The hour when the room closes. Must be after the open time,
+ * 	and at most 24.
  * #return:
  * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent,
  * 	COMPANY_ILLEGAL_PARAMETER - If one of the parameters given does not meet the
@@ -105,12 +111,15 @@ int companyEarns(Company company);
  * 	same id as the id given.
  * 	COMPANY_SUCCESS - Otherwise.
  */
-CompanyResult companyNewRoom(Company company, int id, int entry_fee,
-int recommended_people, int difficulty, char* working_hours);
+CompanyResult companyNewRoom(Company company, RoomIndex index, int id,
+int entry_fee, int recommended_people, int difficulty, int open_time,
+int close_time);
 
 /*
- * Deallocates and removes a room from the company. The room must have no
- * reservations in order for it to be removed successfully.
+ * Deallocates and removes a room from the company (and from the room index).
+ * The room must have no reservations in order for it to be removed
+ * successfully.
+ * 	$index: The room index of the system.
  * 	$id: The id of the required room.
  * #return:
  * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent,
@@ -119,25 +128,38 @@ int recommended_people, int difficulty, char* working_hours);
  * 	COMPANY_ILLEGAL_ID - If there's no room in the company with the required id,
  * 	COMPANY_SUCCESS - Otherwise.
  */
-CompanyResult companyRemoveRoom(Company company, int id);
+CompanyResult companyRemoveRoom(Company company, RoomIndex index, int id);
 
 /*
- * Decreases the scheduled days of all the reservations of all the rooms in the
- * company by one, and fulfills all the reservations that were for today.
+ * Adds all of the company's rooms to a room index (used when a company is
+ * copied into a new system).
+ * #return:
+ * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	COMPANY_ROOM_ID_EXISTS - If one of the rooms' ids already exists in the
+ * 	company's faculty in the index,
+ * 	COMPANY_OUT_OF_MEMORY - If an allocation has failed,
+ * 	COMPANY_SUCCESS - Otherwise.
+ */
+CompanyResult companyIndexRooms(Company company, RoomIndex index);
+
+/*
+ * Removes all of the company's rooms from a room index (used before a company
+ * is removed from the system). The rooms themselves are not affected.
  * #return:
  * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent.
  * 	COMPANY_SUCCESS - Otherwise.
  */
-CompanyResult companyNextDay(Company company);
+CompanyResult companyUnindexRooms(Company company, RoomIndex index);
 
 /*
- * Returns the amount of reservations in all of the company's rooms that are
- * scheduled for today.
+ * Adds the reservations of all of the company's rooms to a calendar (used when
+ * a company is copied into a new system).
  * #return:
- *  0 - If a NULL parameter was sent or there were no reservations for today.
- *  Amount of today's reservations otherwise.
+ * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	COMPANY_OUT_OF_MEMORY - If an allocation has failed,
+ * 	COMPANY_SUCCESS - Otherwise.
  */
-int companyTodaysReservations(Company company);
+CompanyResult companyScheduleReservations(Company company, Calendar calendar);
 
 /*
  * Gets the amount of rooms that belong to this company.
@@ -169,38 +191,48 @@ CompanyResult companyGetRoom(Company company, Room* room, int id);
 bool companyRoomsReserved(Company company);
 
 /*
- * Returns the room in this company with the lowest id.
- * 	$desired_id: Address that will store the id of the room with the lowest id.
- * 	If no acceptable rooms were found - its assigned with a negative value
+ * Updates the amount of reservations in the company's rooms. The company
+ * doesn't see its rooms' reservations being made or removed, so whoever makes
+ * or removes them keeps the company's count up to date. The count is updated
+ * atomically, so the reservations of different rooms can be counted by a few
+ * threads at the same time.
+ * 	$amount: The amount of reservations that were added (or a negative amount,
+ * 	if reservations were removed).
+ * #return:
+ * 	COMPANY_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	COMPANY_INVALID_PARAMETER - If the count would become negative,
+ * 	COMPANY_SUCCESS - Otherwise.
+ */
+CompanyResult companyUpdateReservations(Company company, int amount);
+
+/*
+ * Returns the room in this company with the lowest id, and sets the company's
+ * internal iterator to it. Used in order to go over the company's rooms.
  * #return:
  * 	NULL - If a NULL pointer was sent, or no rooms exist in this company,
  * 	address of the desired room otherwise.
  */
-Room companyLowestIdRoom(Company company, int* desired_id);
+Room companyFirstRoom(Company company);
 
 /*
- * Returns the room in this company with the lowest id that's bigger than a
- * parameter target id.
- * 	$id: Pointer that holds the value of the lower boundary of acceptable room
- * 	ids (no rooms with ids smaller than this (or equal) will be returned).
- * 	If no acceptable rooms were found - its assigned with a negative value
+ * Advances the company's internal iterator to the next room (by id).
  * #return:
- * 	NULL - If a NULL pointer was sent, or no rooms exist in this company that
- * 	have a higher id than the given parameter id,
- * 	address of the desired room otherwise.
+ * 	NULL - If a NULL pointer was sent, or there are no more rooms,
+ * 	address of the next room otherwise.
  */
-Room companyNextRoom(Company company, int* id);
+Room companyNextRoom(Company company);
 
 /*
  * Macro for iterating over all the rooms that belong to this company.
  * Assumption is that 'current_room' is of type 'Room' and 'company' is of type
  * 'Company'. The current_room parameter is the iterator for all the rooms.
- * The iterator Iterates over the list in the order of ids (from smallest to
- * biggest in this company).
+ * The iterator Iterates over the rooms in the order of ids (from smallest to
+ * biggest in this company). The rooms must not be added or removed during the
+ * iteration.
  */
-#define COMPANY_FOREACH(current_room, company, id) \
-	for(Room current_room = companyLowestIdRoom(company, &id); \
+#define COMPANY_FOREACH(current_room, company) \
+	for(Room current_room = companyFirstRoom(company); \
 		current_room != NULL; \
-		current_room = companyNextRoom(company, &id))
+		current_room = companyNextRoom(company))
 
 #endif /* COMPANY_H_ */
@@ -0,0 +1,281 @@
+#include "EmailIndex.h"
+
+/*
+ * An email of the index, and the entity that owns it. The email's id is its
+ * place in the index's array of emails.
+ */
+typedef struct EmailEntry_t {
+	char* email; //The index's copy of the email (NULL if the id is free).
+	unsigned int hash; //The email's hash value, so we don't recalculate it.
+	EmailOwner owner; //The kind of the entity that owns this email.
+	void* entity; //The entity that owns this email (NULL if there's none).
+	int next_free; //If the id is free: the next free id (or EMAIL_INDEX_NO_ID).
+} EmailEntry;
+
+/*
+ * An entry of the index's hash table: an email and its id.
+ */
+typedef struct EmailSlot_t {
+	char* email; //The email (the same copy as the one of its entry).
+	int id; //The email's id.
+} EmailSlot;
+
+/*
+ * Implementation of the EmailIndex ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "EmailIndex".
+ * The emails are kept in an array, by id. An email is found by its id through
+ * a hash table (see HashTable.h). A removed email's id is kept in a list of
+ * free ids, for the next email.
+ */
+struct EmailIndex_t {
+	EmailEntry* entries; //The emails, by id.
+	int entries_amount; //The amount of ids that were given out.
+	int entries_capacity; //The amount of emails the array can hold.
+	int free_id; //The first free id (or EMAIL_INDEX_NO_ID if there's none).
+	HashTable ids; //The ids of the emails, by their emails.
+	int owned; //The amount of emails that have an owner.
+};
+
+//The initial amount of slots in the hash table. Must be a power of 2.
+#define INITIAL_CAPACITY 64
+
+//The array of emails starts with this many emails, and grows by
+//GROWTH_FACTOR each time.
+#define INITIAL_ENTRIES 32
+#define GROWTH_FACTOR 2
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for checking if an id belongs to an email of the index.
+ */
+#define IS_ID(index, id) (((id) >= 0) && ((id) < (index)->entries_amount) && \
+	((index)->entries[(id)].email != NULL))
+
+static unsigned int hashEmail(char* email);
+static bool matchEmail(void* slot, void* email);
+static bool reserveEntry(EmailIndex index);
+static bool insertId(EmailIndex index, char* email, unsigned int hash,
+int id);
+
+/*
+ * A static function that calculates the hash value of an email (FNV-1a).
+ */
+static unsigned int hashEmail(char* email) {
+	assert(email);
+	unsigned int hash = 2166136261u;
+	while(*email) {
+		hash ^= (unsigned char)(*email++);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/*
+ * A static function that checks whether an entry of the hash table is of an
+ * email (the table's match function).
+ */
+static bool matchEmail(void* slot, void* email) {
+	return (strcmp(((EmailSlot*)slot)->email, (char*)email) == 0);
+}
+
+/*
+ * A static function that makes room for one more email in the array of
+ * emails.
+ * #return:
+ * 	false - if an allocation has failed (the index is left unchanged),
+ * 	true - otherwise.
+ */
+static bool reserveEntry(EmailIndex index) {
+	assert(index);
+	if((index->free_id == EMAIL_INDEX_NO_ID) &&
+	(index->entries_amount == index->entries_capacity)) {
+		int new_capacity = (index->entries_capacity == 0) ?
+		(INITIAL_ENTRIES) : (index->entries_capacity*GROWTH_FACTOR);
+		EmailEntry* new_entries = realloc(index->entries,
+		new_capacity*sizeof(*new_entries));
+		CHECK_VALID(new_entries, false)
+		index->entries = new_entries;
+		index->entries_capacity = new_capacity;
+	}
+	return true;
+}
+
+/*
+ * A static function that adds an email and its id to the hash table.
+ * 	$email: The email (the copy that's kept in the email's entry).
+ * 	$hash: The email's hash value.
+ * #return:
+ * 	false - if an allocation has failed (the table is left unchanged),
+ * 	true - otherwise.
+ */
+static bool insertId(EmailIndex index, char* email, unsigned int hash,
+int id) {
+	assert(index && email);
+	EmailSlot* slot = hashTableInsert(NULL, index->ids, hash, email);
+	CHECK_VALID(slot, false)
+	slot->email = email;
+	slot->id = id;
+	return true;
+}
+
+EmailIndex emailIndexCreate() {
+	EmailIndex index = malloc(sizeof(*index));
+	CHECK_VALID(index, NULL)
+	index->ids = hashTableCreate(NULL, sizeof(EmailSlot), INITIAL_CAPACITY,
+	matchEmail);
+	if(!(index->ids)) {
+		free(index);
+		return NULL;
+	}
+	//The array of emails is allocated when the first email is added.
+	index->entries = NULL;
+	index->entries_amount = 0;
+	index->entries_capacity = 0;
+	index->free_id = EMAIL_INDEX_NO_ID;
+	index->owned = 0;
+	return index;
+}
+
+EmailIndexResult emailIndexDestroy(EmailIndex index) {
+	CHECK_VALID(index, EMAIL_INDEX_NULL_PARAMETER)
+	for(int id=0; id<index->entries_amount; id++)
+		free(index->entries[id].email);
+	free(index->entries);
+	hashTableDestroy(index->ids);
+	free(index);
+	return EMAIL_INDEX_SUCCESS;
+}
+
+EmailIndex emailIndexCopy(EmailIndex index) {
+	CHECK_VALID(index, NULL)
+	EmailIndex index_copy = emailIndexCreate();
+	CHECK_VALID(index_copy, NULL)
+	//The copy gets the same ids and free ids, so its emails keep their ids.
+	EmailEntry* entries = (index->entries_amount == 0) ? NULL :
+	malloc(index->entries_amount*sizeof(*entries));
+	if((index->entries_amount > 0) && !entries) {
+		emailIndexDestroy(index_copy);
+		return NULL;
+	}
+	index_copy->entries = entries;
+	index_copy->entries_capacity = index->entries_amount;
+	for(int id=0; id<index->entries_amount; id++) {
+		EmailEntry* entry = &(entries[id]);
+		*entry = index->entries[id];
+		entry->owner = EMAIL_OWNER_NONE;
+		entry->entity = NULL;
+		//Only the emails that were copied are freed if the copy fails.
+		index_copy->entries_amount = id+1;
+		if(!(index->entries[id].email))
+			continue;
+		entry->email = malloc(strlen(index->entries[id].email)+1);
+		if(entry->email)
+			strcpy(entry->email, index->entries[id].email);
+		//The table holds the copy's own emails, so it's filled again.
+		if(!(entry->email) ||
+		!insertId(index_copy, entry->email, entry->hash, id)) {
+			emailIndexDestroy(index_copy);
+			return NULL;
+		}
+	}
+	index_copy->free_id = index->free_id;
+	return index_copy;
+}
+
+EmailIndexResult emailIndexIntern(EmailIndex index, char* email, int* id) {
+	CHECK_VALID(index, EMAIL_INDEX_NULL_PARAMETER)
+	CHECK_VALID(email, EMAIL_INDEX_NULL_PARAMETER)
+	CHECK_VALID(id, EMAIL_INDEX_NULL_PARAMETER)
+	unsigned int hash = hashEmail(email);
+	CHECK_VALID(!hashTableFind(index->ids, hash, email),
+	EMAIL_INDEX_EMAIL_EXISTS)
+	char* email_copy = malloc(strlen(email)+1);
+	CHECK_VALID(email_copy, EMAIL_INDEX_OUT_OF_MEMORY)
+	if(!reserveEntry(index)) {
+		free(email_copy);
+		return EMAIL_INDEX_OUT_OF_MEMORY;
+	}
+	strcpy(email_copy, email);
+	int new_id = (index->free_id != EMAIL_INDEX_NO_ID) ? (index->free_id) :
+	(index->entries_amount);
+	if(!insertId(index, email_copy, hash, new_id)) {
+		free(email_copy);
+		return EMAIL_INDEX_OUT_OF_MEMORY;
+	}
+	if(new_id == index->free_id)
+		index->free_id = index->entries[new_id].next_free;
+	else
+		(index->entries_amount)++;
+	EmailEntry* entry = &(index->entries[new_id]);
+	entry->email = email_copy;
+	entry->hash = hash;
+	entry->owner = EMAIL_OWNER_NONE;
+	entry->entity = NULL;
+	entry->next_free = EMAIL_INDEX_NO_ID;
+	*id = new_id;
+	return EMAIL_INDEX_SUCCESS;
+}
+
+int emailIndexGetId(EmailIndex index, char* email) {
+	CHECK_VALID(index, EMAIL_INDEX_NO_ID)
+	CHECK_VALID(email, EMAIL_INDEX_NO_ID)
+	EmailSlot* slot = hashTableFind(index->ids, hashEmail(email), email);
+	return (slot) ? (slot->id) : (EMAIL_INDEX_NO_ID);
+}
+
+char* emailIndexGetEmail(EmailIndex index, int id) {
+	CHECK_VALID(index, NULL)
+	CHECK_VALID(IS_ID(index, id), NULL)
+	return index->entries[id].email;
+}
+
+EmailIndexResult emailIndexAdd(EmailIndex index, int id, EmailOwner owner,
+void* entity) {
+	CHECK_VALID(index, EMAIL_INDEX_NULL_PARAMETER)
+	CHECK_VALID(entity, EMAIL_INDEX_NULL_PARAMETER)
+	CHECK_VALID(IS_ID(index, id), EMAIL_INDEX_EMAIL_DOES_NOT_EXIST)
+	CHECK_VALID((index->entries[id].owner == EMAIL_OWNER_NONE),
+	EMAIL_INDEX_EMAIL_EXISTS)
+	index->entries[id].owner = owner;
+	index->entries[id].entity = entity;
+	(index->owned)++;
+	return EMAIL_INDEX_SUCCESS;
+}
+
+EmailIndexResult emailIndexRemove(EmailIndex index, int id) {
+	CHECK_VALID(index, EMAIL_INDEX_NULL_PARAMETER)
+	CHECK_VALID(IS_ID(index, id), EMAIL_INDEX_EMAIL_DOES_NOT_EXIST)
+	EmailEntry* entry = &(index->entries[id]);
+	hashTableRemove(index->ids, hashTableFind(index->ids, entry->hash,
+	entry->email));
+	if(entry->owner != EMAIL_OWNER_NONE)
+		(index->owned)--;
+	free(entry->email);
+	entry->email = NULL;
+	entry->owner = EMAIL_OWNER_NONE;
+	entry->entity = NULL;
+	entry->next_free = index->free_id;
+	index->free_id = id;
+	return EMAIL_INDEX_SUCCESS;
+}
+
+EmailOwner emailIndexFind(EmailIndex index, int id, void** entity) {
+	CHECK_VALID(index, EMAIL_OWNER_NONE)
+	CHECK_VALID(IS_ID(index, id), EMAIL_OWNER_NONE)
+	if(entity)
+		*entity = index->entries[id].entity;
+	return index->entries[id].owner;
+}
+
+int emailIndexGetSize(EmailIndex index) {
+	CHECK_VALID(index, -1)
+	return index->owned;
+}
@@ -0,0 +1,143 @@
+#ifndef EMAILINDEX_H_
+#define EMAILINDEX_H_
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "HashTable.h"
+
+typedef struct EmailIndex_t *EmailIndex; //Name of the ADT.
+
+typedef enum {
+	//The email index's errors:
+	EMAIL_INDEX_SUCCESS,
+	EMAIL_INDEX_NULL_PARAMETER,
+	EMAIL_INDEX_OUT_OF_MEMORY,
+	EMAIL_INDEX_EMAIL_EXISTS,
+	EMAIL_INDEX_EMAIL_DOES_NOT_EXIST,
+} EmailIndexResult;
+
+typedef enum {
+	//The kinds of entities that may own an email in the system:
+	EMAIL_OWNER_COMPANY,
+	EMAIL_OWNER_ESCAPER,
+	EMAIL_OWNER_NONE,
+} EmailOwner;
+
+//The id of an email that isn't in the index.
+#define EMAIL_INDEX_NO_ID -1
+
+/*
+ * Allocates a new, empty email index.
+ * The index interns the emails of the system: every email that enters the
+ * system gets a copy in the index and a small integer id (0, 1, 2...), and
+ * keeps that id until it's removed from the index (along with the entity that
+ * owns it). The id of a removed email is given to the next email that's
+ * added, so the ids stay as few as the emails. The entities and the
+ * reservations hold the id instead of the email, so comparing two emails is
+ * comparing two integers.
+ * The index also maps an id to the entity that owns it (either a company or an
+ * escaper). Since an email is unique in the system across both kinds of
+ * entities, a single index serves them both.
+ * #return:
+ * 	NULL if an allocation has failed,
+ * 	and a new email index otherwise.
+ */
+EmailIndex emailIndexCreate();
+
+/*
+ * Deallocates an email index, with all the emails it holds. The entities the
+ * index points to are not affected.
+ * #return:
+ * 	EMAIL_INDEX_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	EMAIL_INDEX_SUCCESS - Otherwise.
+ */
+EmailIndexResult emailIndexDestroy(EmailIndex index);
+
+/*
+ * Creates a copy of an email index. The copy has the same emails with the same
+ * ids (and gives out the same ids next), but none of them has an owner (the
+ * copied entities are added to it).
+ * #return:
+ * 	NULL if a NULL pointer was sent or an allocation has failed,
+ * 	and a copy of the index otherwise.
+ */
+EmailIndex emailIndexCopy(EmailIndex index);
+
+/*
+ * Adds a new email to the index, without an owner, and gives it an id. The
+ * email should get its owner with emailIndexAdd, or be removed with
+ * emailIndexRemove if the owner couldn't be created.
+ * 	$email: The email. The index keeps its own copy of it.
+ * 	$id: Address where the email's id will be stored.
+ * #return:
+ * 	EMAIL_INDEX_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	EMAIL_INDEX_EMAIL_EXISTS - If the email is already in the index,
+ * 	EMAIL_INDEX_OUT_OF_MEMORY - If an allocation has failed,
+ * 	EMAIL_INDEX_SUCCESS - Otherwise.
+ */
+EmailIndexResult emailIndexIntern(EmailIndex index, char* email, int* id);
+
+/*
+ * Gets the id of an email, without adding it to the index.
+ * #return:
+ * 	EMAIL_INDEX_NO_ID - If a NULL pointer was sent or the email isn't in the
+ * 	index,
+ * 	and the email's id otherwise.
+ */
+int emailIndexGetId(EmailIndex index, char* email);
+
+/*
+ * Gets the email of an id. The email belongs to the index: it stays valid for
+ * as long as the index does, and mustn't be changed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent or there's no email with that id,
+ * 	and the email otherwise.
+ */
+char* emailIndexGetEmail(EmailIndex index, int id);
+
+/*
+ * Sets the entity that owns an email.
+ * 	$id: The email's id.
+ * 	$owner: The kind of the entity that owns the email.
+ * 	$entity: The entity that owns the email.
+ * #return:
+ * 	EMAIL_INDEX_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	EMAIL_INDEX_EMAIL_DOES_NOT_EXIST - If there's no email with that id,
+ * 	EMAIL_INDEX_EMAIL_EXISTS - If the email already has an owner,
+ * 	EMAIL_INDEX_SUCCESS - Otherwise.
+ */
+EmailIndexResult emailIndexAdd(EmailIndex index, int id, EmailOwner owner,
+void* entity);
+
+/*
+ * Removes an email (and its owner, if it has one) from the index. Its id is
+ * given to the next email that's added.
+ * #return:
+ * 	EMAIL_INDEX_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	EMAIL_INDEX_EMAIL_DOES_NOT_EXIST - If there's no email with that id,
+ * 	EMAIL_INDEX_SUCCESS - Otherwise.
+ */
+EmailIndexResult emailIndexRemove(EmailIndex index, int id);
+
+/*
+ * Finds the entity that owns an email.
+ * 	$id: The email's id (EMAIL_INDEX_NO_ID is an email with no owner).
+ * 	$entity: Address where the entity will be stored. Can be sent as NULL if
+ * 	only the kind of the owner is needed.
+ * #return:
+ * 	EMAIL_OWNER_NONE - If a NULL parameter was sent or the email has no owner,
+ * 	and the kind of the entity that owns the email otherwise.
+ */
+EmailOwner emailIndexFind(EmailIndex index, int id, void** entity);
+
+/*
+ * Returns the amount of emails in the index that have an owner.
+ * #return:
+ * 	-1 - If a NULL pointer was sent,
+ * 	and the amount of owned emails in the index otherwise.
+ */
+int emailIndexGetSize(EmailIndex index);
+
+#endif /* EMAILINDEX_H_ */
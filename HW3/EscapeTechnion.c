@@ -1,24 +1,72 @@
+#define _POSIX_C_SOURCE 200112L //For pthreads.
+#include <pthread.h>
 #include "EscapeTechnion.h"
 
+/*
+ * An immutable view of the faculties' earnings, as the best faculties report
+ * reads them. A new view is published whenever an operation that changes the
+ * earnings is done, so a view is always consistent with one point in time.
+ * A reader pins the latest view and reads it without holding the system, and
+ * a view that was replaced is freed by its last reader.
+ * The publication is ordered by the pointer to the latest view: the publisher
+ * writes all of a view's fields and only then stores the pointer (a release
+ * store), and a reader loads the pointer (an acquire load) before it reads
+ * any field. So a reader that gets a view sees all of it, and never a view
+ * that's still being written. The view lock only guards the readers count and
+ * the retiring of views.
+ */
+typedef struct EarningsView_t {
+	int days_passed; //The day the view was published in.
+	int total_earns; //The revenue of all the faculties together.
+	TechnionFaculty ranking[UNKNOWN]; //Faculties, from best to worst.
+	int faculty_earns[UNKNOWN]; //The revenue of every faculty.
+	int readers; //The amount of readers that pinned the view.
+	bool retired; //Whether a newer view was published instead of this one.
+} EarningsView;
+
 /*
  * Implementation of the EscapeTechnion ADT declared in the .h file:
  * The struct's exposed name is of the pointer "EscapeTechnion".
+ * Orders and recommendations can be made by a few threads at the same time
+ * (see the .h file). Each of them changes only its escaper and its room, and
+ * the parts of the system they share are guarded for as long as they're
+ * changed: the reservations pool by its own lock, the calendar by the
+ * calendar lock and the companies' counts by atomic updates. The email index,
+ * the room index and the earnings are only read by them, and are only changed
+ * by the operations that change the system alone.
  */
 struct EscapeTechnion_t {
 	int days_passed; //Amount of days passed since the creation of the system.
 	Set escapers; //Set of escapers.
 	Set companies; //Set of companies.
+	EmailIndex emails; //Maps every email in the system to its owner.
+	RoomIndex rooms; //Maps every (faculty, id) pair to its room and company.
+	Calendar calendar; //The reservations of every day, in the report's order.
+	Pool reservation_pool; //The reservations that were ordered in the system.
+	int faculty_earns[UNKNOWN]; //The revenue of every faculty.
+	int total_earns; //The revenue of all the faculties together.
+	TechnionFaculty faculty_ranking[UNKNOWN]; //Faculties, from best to worst.
 	FILE* output_channel; //The output channel for the system.
+	ReportWriter report_writer; //Builds the day reports (NULL if disabled).
+	int report_workers; //The amount of threads that build a day's report.
+	ReportWriter* part_writers; //The parts of the workers after the first.
+	EarningsView* earnings_view; //The latest published view (see above).
+	EarningsView* spare_view; //The next view to publish (NULL if none yet).
+	pthread_mutex_t view_lock; //Guards the pinning of the views.
+	pthread_mutex_t calendar_lock; //Guards the calendar while orders add to it.
 };
 
-//In our format, hours are represented as two digits.
-#define HR_DIGITS 2
-
-//In our format, days and hours are separated with a dash sign.
-#define SEPARATE_FIELDS '-'
-
-//A valid email must contain exactly one of this sign
-#define EMAIL_SIGN '@'
+/*
+ * The part of a day's report that one worker builds: a range of the day's
+ * reservations (which are already in the report's order).
+ */
+typedef struct ReportPart_t {
+	EscapeTechnion sys;
+	int day;
+	int first; //The first reservation of the part.
+	int end; //The reservation after the last reservation of the part.
+	ReportWriter writer;
+} ReportPart;
 
 //The maximum possible skill / difficulty
 #define MAX_LEVEL 10
@@ -29,6 +77,13 @@ struct EscapeTechnion_t {
 //The amount of faculties being printed as the best ones
 #define BEST_FACULTIES_AMOUNT 3
 
+//The most threads a day's report can be built by
+#define MAX_REPORT_WORKERS 64
+
+//A day with less reservations is reported by one thread (starting the other
+//threads would take longer than building the whole report)
+#define PARALLEL_REPORT_MINIMUM 1024
+
 /*
  * A macro for checking the validity of a boolean condition.
  * 	$bool_condition - any boolean condition.
@@ -39,9 +94,10 @@ struct EscapeTechnion_t {
 	if(!(bool_condition)) { return res; }
 
 /*
- * A macro for calculating the absolute distance between two numbers.
+ * A macro for assigning a value to a pointer iff it's not NULL.
  */
-#define ABSOLUTE_DISTANCE(x, y) ((x) < (y) ? (y-x) : (x-y))
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
 
 //START OF STATIC FUNCTIONS
 
@@ -51,40 +107,67 @@ static int setCompanyCompare(SetElement company1, SetElement company2);
 static SetElement setEscaperCopy(SetElement escaper);
 static void setEscaperFree(SetElement escaper);
 static int setEscaperCompare(SetElement escaper1, SetElement escaper2);
-static bool isLegalEmail(char* email);
 static bool checkRoomParameters(int id, int entry_fee, int recommended_people,
-int difficulty, char* working_hours);
-static int exponent10(int num, int p);
-static bool checkHours(char *working_hours, int *time);
-static bool checkReservationTime(char* date, int room_open, int room_close);
-static bool validateDate(char *date, char delimeter);
-static bool readDate(char *date, int *days, int* hour);
+int difficulty, int open, int close);
+static bool checkReservationTime(char* date, int room_open, int room_close,
+int* days, int* hour);
 static Company getCompanyByEmail(EscapeTechnion sys, char* email);
 static Company getCompanyByRoomId(EscapeTechnion sys, TechnionFaculty faculty,
 int id);
 static Escaper getEscaperByEmail(EscapeTechnion sys, char* email);
+static Escaper getEscaperById(EscapeTechnion sys, int email_id);
 static Room getFacultyRoomById(EscapeTechnion sys, int id,
 TechnionFaculty faculty);
 static Room recommendedRoom(EscapeTechnion sys, int escaper_skill_level,
 int num_ppl, TechnionFaculty escaper_faculty, TechnionFaculty* room_faculty);
-static void updateRecommendedRoomValues(int* min, Room* best_room,
-TechnionFaculty* best_faculty, int score, Room room, TechnionFaculty faculty);
-static int numDigits(int num);
-static void fillDate(char *date, int days, int hour);
-static void dateNextRoomHour(Room room, char* date, int days, int hour);
-static int systemTodaysReservations(EscapeTechnion sys);
-static void printReservation(EscapeTechnion sys, Company curr_company,
-Room curr_room, Reservation curr_reservation);
-static void systemFillTopFaculties(EscapeTechnion sys, int faculty_earns[],
-TechnionFaculty best_faculties[]);
+static EscapeTechnionResult findRecommendation(EscapeTechnion sys,
+char* email, int num_ppl, Escaper* escaper, Room* room,
+TechnionFaculty* room_faculty);
+static void printReservation(EscapeTechnion sys, ReportWriter writer,
+Company curr_company, Room curr_room, Reservation curr_reservation);
+static void* buildReportPart(void* part);
+static void printDayReservations(EscapeTechnion sys, int day, int total_res);
+static void destroyPartWriters(EscapeTechnion sys);
+static bool reserveView(EscapeTechnion sys);
+static void publishView(EscapeTechnion sys);
+static EarningsView* pinView(EscapeTechnion sys);
+static void releaseView(EscapeTechnion sys, EarningsView* view);
+static bool facultyRanksBefore(EscapeTechnion sys, TechnionFaculty faculty1,
+TechnionFaculty faculty2);
+static void systemUpdateEarns(EscapeTechnion sys, TechnionFaculty faculty,
+int amount);
+static EscapeTechnionResult systemAddCompany(EscapeTechnion sys,
+Company company);
+static EscapeTechnionResult systemAddEscaper(EscapeTechnion sys,
+Escaper escaper);
+static EscaperResult systemMakeReservation(EscapeTechnion sys,
+Escaper escaper, Room room, TechnionFaculty faculty, int num_ppl, int day,
+int hour);
+static bool systemLinkReservations(EscapeTechnion sys);
+static EscapeTechnionResult checkpointError(Checkpoint checkpoint);
+static void saveCompany(EscapeTechnion sys, Checkpoint checkpoint,
+Company company);
+static void saveEscaper(EscapeTechnion sys, Checkpoint checkpoint,
+Escaper escaper);
+static EscapeTechnionResult loadRoom(EscapeTechnion sys,
+Checkpoint checkpoint, Company company, TechnionFaculty faculty);
+static EscapeTechnionResult loadCompany(EscapeTechnion sys,
+Checkpoint checkpoint);
+static EscapeTechnionResult loadReservation(EscapeTechnion sys,
+Checkpoint checkpoint, Escaper escaper);
+static EscapeTechnionResult loadEscaper(EscapeTechnion sys,
+Checkpoint checkpoint);
 
 //END OF STATIC FUNCTIONS
 
 /*
- * Defining the copy function for a set of companies
+ * Defining the copy function for a set of companies.
+ * The system's sets take ownership of the companies that are added to them
+ * (instead of keeping a copy), so the company that was added is the same
+ * company the email index points to.
  */
 static SetElement setCompanyCopy(SetElement company) {
-	return companyCopy((Company)company);
+	return company;
 }
 
 /*
@@ -98,18 +181,18 @@ static void setCompanyFree(SetElement company) {
  * Defining the compare function for a set of companies
  */
 static int setCompanyCompare(SetElement company1, SetElement company2) {
-	char* email1 = NULL;
-	char* email2 = NULL;
-	companyGetEmail((Company)company1, &email1);
-	companyGetEmail((Company)company2, &email2);
-	return (strcmp(email1, email2));
+	int email_id1 = 0, email_id2 = 0;
+	companyGetEmailId((Company)company1, &email_id1);
+	companyGetEmailId((Company)company2, &email_id2);
+	return (email_id1 - email_id2);
 }
 
 /*
- * Defining the copy function for a set of escapers
+ * Defining the copy function for a set of escapers.
+ * Just like the companies set - the set takes ownership of the given escaper.
  */
 static SetElement setEscaperCopy(SetElement escaper) {
-	return escaperCopy((Escaper)escaper);
+	return escaper;
 }
 
 /*
@@ -123,22 +206,10 @@ static void setEscaperFree(SetElement escaper) {
  * Defining the compare function for a set of escapers
  */
 static int setEscaperCompare(SetElement escaper1, SetElement escaper2) {
-	char* email1 = NULL;
-	char* email2 = NULL;
-	escaperGetEmail((Escaper)escaper1, &email1);
-	escaperGetEmail((Escaper)escaper2, &email2);
-	return (strcmp(email1, email2));
-}
-
-/*
- * Checks if the email address contains exactly one '@'
- */
-static bool isLegalEmail(char* email) {
-	int i=0, count=0;
-	while(email[i])
-		if(email[i++] == EMAIL_SIGN)
-			count++;
-	return (count == 1);
+	int email_id1 = 0, email_id2 = 0;
+	escaperGetEmailId((Escaper)escaper1, &email_id1);
+	escaperGetEmailId((Escaper)escaper2, &email_id2);
+	return (email_id1 - email_id2);
 }
 
 /*
@@ -147,110 +218,26 @@ static bool isLegalEmail(char* email) {
  * system ADT because of the order of errors returned from the function...
  */
 static bool checkRoomParameters(int id, int entry_fee, int recommended_people,
-int difficulty, char* working_hours) {
-	CHECK_VALID((working_hours), false)
+int difficulty, int open, int close) {
 	CHECK_VALID((id > 0), false)
 	CHECK_VALID(((entry_fee>=0) && (entry_fee%MULTIPLE == 0)), false)
 	CHECK_VALID((recommended_people > 0), false)
 	CHECK_VALID(((difficulty>=1) && (difficulty<=10)), false)
-	CHECK_VALID((strlen(working_hours) == (2*HR_DIGITS + 1)), false)
-	CHECK_VALID((working_hours[HR_DIGITS] == SEPARATE_FIELDS), false)
-	int open=0, close=0;
-	CHECK_VALID((checkHours(working_hours, &open)), false)
-	CHECK_VALID((checkHours((working_hours+HR_DIGITS+1), &close)), false)
 	CHECK_VALID((open >= 0 && close > open && close <= HOURS_IN_A_DAY), false)
 	CHECK_VALID(((close) > (open)), false)
 	return true;
 }
 
-/*
- * Checks that the hours string is valid (one field at a time), and converts
- * result into a parameter address
- */
-static bool checkHours(char *working_hours, int *time) {
-	int temp_digit = 0;
-	(*time) = 0;
-	for(int i = 0; i<HR_DIGITS; i++) {
-		temp_digit = (int)((*(working_hours+i)) - '0');
-		if(temp_digit<0 || temp_digit>9) return false;
-		(*time)+= exponent10(temp_digit, (HR_DIGITS-1-i));
-	}
-	return true;
-}
-
-/*
- * Arithmetical exponent function: num*10^p
- */
-static int exponent10(int num, int p) {
-	if(num==0)
-		return 0;
-	int result = num;
-	for(int i=0; i<p; i++)
-		result*=10;
-	return result;
-}
-
 /*
  * Checks if a reservation's scheduled time is within the open and close hours
- * of a room
- */
-static bool checkReservationTime(char* date, int room_open, int room_close) {
-	int days=0, hour=0;
-	CHECK_VALID((readDate(date, &days, &hour)), false)
-	CHECK_VALID((((hour)>=room_open) && (hour)<room_close), false)
-	return true;
-}
-
-/*
- * Validates a reservation's scheduled date
+ * of a room. If it is, the days and hour of the date are stored in the given
+ * addresses, so the date doesn't have to be read again.
  */
-static bool validateDate(char *date, char delimeter) {
-	assert(date);
-	int i = 0;
-	bool changed_delim = false, field1_flag = false, field2_flag = false;
-	while(date[i++]) {
-		if((!changed_delim) && (date[i-1] == delimeter)) {
-			//the delimeter '-' was found
-			date[i-1] = ' ';
-			changed_delim = true;
-			continue;
-		}
-		else if(date[i-1] < '0' || date[i-1] > '9')
-			//non-delimeter, non-digit char
-			return false;
-		if (!changed_delim)
-			//field1 (days): valid digit
-			field1_flag = true;
-		else
-			//field2 (hour): valid digit
-			field2_flag = true;
-	}
-	if(!changed_delim || !field1_flag || !field2_flag)
-		return false;
-	return true;
-}
-
-/*
- * A static function used to check the validity of the date.
- * 	$date: the date string, of the format "dd-hh".
- *	$days: the address of a value that will store either the day
- *	$hour: the address of a value that will store the hour
- * #return:
- * 	false - if the field that was checked (either day or hour) was not a valid
- * 	number, and true - otherwise.
- */
-static bool readDate(char *date, int *days, int* hour) {
-	assert(date);
-	char* date_copy = malloc(sizeof(date)+1);
-	if(!date_copy)
-		return false;
-	strcpy(date_copy, date);
-	if(!validateDate(date_copy, SEPARATE_FIELDS)) {
-		free(date_copy);
-		return false;
-	}
-	sscanf(date_copy, "%d %d", days, hour);
-	free(date_copy);
+static bool checkReservationTime(char* date, int room_open, int room_close,
+int* days, int* hour) {
+	assert(days && hour);
+	CHECK_VALID((fieldReadTime(date, days, hour)), false)
+	CHECK_VALID((((*hour)>=room_open) && (*hour)<room_close), false)
 	return true;
 }
 
@@ -260,14 +247,11 @@ static bool readDate(char *date, int *days, int* hour) {
  */
 static Company getCompanyByEmail(EscapeTechnion sys, char* email) {
 	assert(sys && email);
-	char* target_email = NULL;
-	SET_FOREACH(Company, target_company, sys->companies) {
-		assert(target_company);
-		companyGetEmail(target_company, &target_email);
-		if(strcmp(email, target_email) == 0)
-			return target_company;
-	}
-	return NULL;
+	void* company = NULL;
+	if(emailIndexFind(sys->emails, emailIndexGetId(sys->emails, email),
+	&company) != EMAIL_OWNER_COMPANY)
+		return NULL;
+	return (Company)company;
 }
 
 /*
@@ -277,18 +261,9 @@ static Company getCompanyByEmail(EscapeTechnion sys, char* email) {
 static Company getCompanyByRoomId(EscapeTechnion sys, TechnionFaculty faculty,
 int id) {
 	assert(sys);
-	TechnionFaculty target_faculty = UNKNOWN;
-	Room room = NULL;
-	SET_FOREACH(Company, company, sys->companies) {
-		assert(company);
-		companyGetFaculty(company, &target_faculty);
-		if(faculty == target_faculty) {
-			companyGetRoom(company, &room, id);
-			if(room != NULL)
-				return company;
-		}
-	}
-	return NULL;
+	Company company = NULL;
+	roomIndexFind(sys->rooms, faculty, id, &company);
+	return company;
 }
 
 /*
@@ -297,14 +272,19 @@ int id) {
  */
 static Escaper getEscaperByEmail(EscapeTechnion sys, char* email) {
 	assert(sys && email);
-	char* target_email = NULL;
-	SET_FOREACH(Escaper, target_escaper, sys->escapers) {
-		assert(target_escaper);
-		escaperGetEmail(target_escaper, &target_email);
-		if((target_email) && strcmp(email, target_email) == 0)
-			return target_escaper;
-	}
-	return NULL;
+	return getEscaperById(sys, emailIndexGetId(sys->emails, email));
+}
+
+/*
+ * Gets the id of a user's email in the system and returns the user (or NULL if
+ * it does not exist)
+ */
+static Escaper getEscaperById(EscapeTechnion sys, int email_id) {
+	assert(sys);
+	void* escaper = NULL;
+	if(emailIndexFind(sys->emails, email_id, &escaper) != EMAIL_OWNER_ESCAPER)
+		return NULL;
+	return (Escaper)escaper;
 }
 
 /*
@@ -314,18 +294,7 @@ static Escaper getEscaperByEmail(EscapeTechnion sys, char* email) {
 static Room getFacultyRoomById(EscapeTechnion sys, int id,
 TechnionFaculty faculty) {
 	assert(sys);
-	TechnionFaculty target_faculty;
-	Room desired_room = NULL;
-	SET_FOREACH(Company, company, sys->companies) {
-		assert(company);
-		companyGetFaculty(company, &target_faculty);
-		if(faculty == target_faculty) {
-			CompanyResult result = companyGetRoom(company, &desired_room, id);
-			if(result == COMPANY_SUCCESS)
-				return desired_room;
-		}
-	}
-	return NULL;
+	return roomIndexFind(sys->rooms, faculty, id, NULL);
 }
 
 /*
@@ -333,167 +302,384 @@ TechnionFaculty faculty) {
  *	to the parameters given), and returns it (or NULL if there are no rooms
  *	in the system). If multiple rooms with the same score are found - the one
  *	that belongs to the faculty that's relatively closer to the escaper's
- *	faculty is returned.
+ *	faculty is returned, and then the one with the lowest id. The rooms are
+ *	looked up in the room index's grid rather than scored one by one.
  */
 static Room recommendedRoom(EscapeTechnion sys, int escaper_skill_level,
 int num_ppl, TechnionFaculty escaper_faculty, TechnionFaculty* room_faculty) {
-	TechnionFaculty faculty = UNKNOWN, best_faculty = UNKNOWN;
-	companyGetFaculty(setGetFirst(sys->companies), &best_faculty);
-	int id=0, score=0;
-	Room best_room = companyLowestIdRoom(setGetFirst(sys->companies), &id);
-	if(!best_room)
-		//There are no rooms in the system!
-		return NULL;
-	int min_score=roomCalculatedScore(best_room, escaper_skill_level, num_ppl);
-	//There are rooms in the company.
-	for(TechnionFaculty curr_faculty=0; curr_faculty<UNKNOWN; curr_faculty++){
-		SET_FOREACH(Company, company, sys->companies) {
-			companyGetFaculty(company, &faculty);
-			if(faculty != curr_faculty)
-				break;
-			//The company is of the desired faculty
-			COMPANY_FOREACH(room, company, id) {
-				score = roomCalculatedScore(room, escaper_skill_level,
-				num_ppl);
-				if(score > min_score)
-					continue;
-				//Found a potential best room
-				if(score < min_score) {
-					updateRecommendedRoomValues(&min_score, &best_room,
-					&best_faculty, score, room, curr_faculty);
-				}
-				else {
-					//Found two rooms with the same score
-					int diff1=ABSOLUTE_DISTANCE(escaper_faculty, curr_faculty);
-					int diff2=ABSOLUTE_DISTANCE(escaper_faculty, best_faculty);
-					if(diff1 < diff2) {
-						//The newly found room is of a relatively closer
-						//faculty to the escaper!
-						updateRecommendedRoomValues(&min_score, &best_room,
-						&best_faculty, score, room, curr_faculty);
-					}
-				}
-			}
+	assert(sys);
+	return roomIndexBestRoom(sys->rooms, escaper_skill_level, num_ppl,
+	escaper_faculty, room_faculty);
+}
+
+/*
+ * Finds the escaper of an email and the room that's recommended for it.
+ * #return:
+ * 	The error a recommendation returns if it can't be made, and
+ * 	ESCAPE_TECHNION_SUCCESS otherwise (only then are the escaper, the room and
+ * 	its faculty stored).
+ */
+static EscapeTechnionResult findRecommendation(EscapeTechnion sys,
+char* email, int num_ppl, Escaper* escaper, Room* room,
+TechnionFaculty* room_faculty) {
+	assert(escaper && room && room_faculty);
+	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
+	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(((num_ppl)>0),ESCAPE_TECHNION_INVALID_PARAMETER)
+	int skill_level = 0;
+	TechnionFaculty escaper_faculty = UNKNOWN;
+	*escaper = getEscaperByEmail(sys, email);
+	CHECK_VALID(*escaper, ESCAPE_TECHNION_CLIENT_EMAIL_DOES_NOT_EXIST)
+	escaperGetSkillLevel(*escaper, &skill_level);
+	escaperGetFaculty(*escaper, &escaper_faculty);
+	*room = recommendedRoom(sys, skill_level, num_ppl, escaper_faculty,
+	room_faculty);
+	CHECK_VALID(*room, ESCAPE_TECHNION_NO_ROOMS_AVAILABLE)
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
+/*
+ * A reservation was sent to be printed, all of its data is here: the company
+ * to which the room belongs, the room itself and the reservation.
+ * We decipher all the relevant data for the print function thanks to the
+ * ADT's getter functions, and send all of the data to be printed.
+ */
+static void printReservation(EscapeTechnion sys, ReportWriter writer,
+Company company, Room room, Reservation reservation) {
+	assert(sys && company && room && reservation);
+	TechnionFaculty escaper_faculty=UNKNOWN, room_faculty=UNKNOWN;
+	int escaper_skill=0, room_id=0, reservation_hour=0,
+	reservation_participants=0, reservation_price=0, room_difficulty=0,
+	company_email_id=0, escaper_email_id=reservationGetEscaperId(reservation);
+	companyGetEmailId(company, &company_email_id);
+	//The emails are only looked up here, when they're printed.
+	char* company_email = emailIndexGetEmail(sys->emails, company_email_id);
+	char* escaper_email = emailIndexGetEmail(sys->emails, escaper_email_id);
+	Escaper escaper = getEscaperById(sys, escaper_email_id);
+	assert(escaper && company_email && escaper_email);
+	escaperGetSkillLevel(escaper, &escaper_skill);
+	escaperGetFaculty(escaper, &escaper_faculty);
+	companyGetFaculty(company, &room_faculty);
+	roomGetId(room, &room_id);
+	roomGetDifficulty(room, &room_difficulty);
+	reservation_hour = reservationGetHour(reservation);
+	reservation_participants = reservationGetPeople(reservation);
+	reservation_price = reservationGetPrice(reservation);
+	if(writer) {
+		reportWriterOrder(writer, escaper_email, escaper_skill,
+		escaper_faculty, company_email, room_faculty, room_id,
+		reservation_hour, room_difficulty, reservation_participants,
+		reservation_price);
+		return;
+	}
+	mtmPrintOrder(sys->output_channel, escaper_email, escaper_skill,
+	escaper_faculty, company_email, room_faculty, room_id, reservation_hour,
+	room_difficulty, reservation_participants, reservation_price);
+}
+
+/*
+ * A thread's function for building a part of a day's report in the part's
+ * writer. It only reads the system, so the parts can be built together.
+ */
+static void* buildReportPart(void* part) {
+	ReportPart* report_part = part;
+	assert(report_part && report_part->writer);
+	Room room = NULL;
+	Company company = NULL;
+	for(int i=report_part->first; i<report_part->end; i++) {
+		Reservation reservation = calendarGetReservation(
+		report_part->sys->calendar, report_part->day, i, &room, &company);
+		printReservation(report_part->sys, report_part->writer, company, room,
+		reservation);
+	}
+	return NULL;
+}
+
+/*
+ * Prints the reservations of a day. A big day (with buffered output and more
+ * than one worker) is split into consecutive parts, one for each worker, and
+ * the parts are built at the same time, each in its own writer. The day's
+ * reservations are already sorted in the report's order, so putting the parts
+ * one after the other gives the same report a single thread would build.
+ * If a thread can't be started, its part is built by this thread.
+ */
+static void printDayReservations(EscapeTechnion sys, int day, int total_res) {
+	assert(sys);
+	if(!(sys->report_writer)) {
+		Room room = NULL;
+		Company company = NULL;
+		for(int i=0; i<total_res; i++) {
+			Reservation reservation = calendarGetReservation(sys->calendar, day,
+			i, &room, &company);
+			printReservation(sys, NULL, company, room, reservation);
 		}
+		return;
 	}
-	*room_faculty = best_faculty;
-	return best_room;
+	int workers = (total_res >= PARALLEL_REPORT_MINIMUM) ?
+	(sys->report_workers) : 1;
+	ReportPart parts[MAX_REPORT_WORKERS];
+	pthread_t threads[MAX_REPORT_WORKERS];
+	bool started[MAX_REPORT_WORKERS] = {false};
+	for(int i=0; i<workers; i++) {
+		parts[i].sys = sys;
+		parts[i].day = day;
+		parts[i].first = (int)(((long)total_res * i) / workers);
+		parts[i].end = (int)(((long)total_res * (i+1)) / workers);
+		//The first part goes straight after the day's header.
+		parts[i].writer = (i == 0) ? (sys->report_writer) :
+		(sys->part_writers[i-1]);
+		if(i > 0)
+			started[i] = (pthread_create(&threads[i], NULL, buildReportPart,
+			&parts[i]) == 0);
+	}
+	buildReportPart(&parts[0]);
+	for(int i=1; i<workers; i++) {
+		if(started[i])
+			pthread_join(threads[i], NULL);
+		else
+			buildReportPart(&parts[i]);
+		reportWriterAppend(sys->report_writer, parts[i].writer);
+	}
+}
+
+/*
+ * Destroys the writers of the report's parts (if there are any).
+ */
+static void destroyPartWriters(EscapeTechnion sys) {
+	assert(sys);
+	if(!(sys->part_writers))
+		return;
+	for(int i=0; i<sys->report_workers-1; i++)
+		reportWriterDestroy(sys->part_writers[i]);
+	free(sys->part_writers);
+	sys->part_writers = NULL;
 }
 
 /*
- * A simple re-assignment function of 3 parameters, to prevent code duplication.
+ * Makes sure there's a view to publish the earnings in, so that publishing
+ * can't fail after an operation has changed the system. Usually, the view that
+ * was replaced last is reused.
+ * #return:
+ * 	false - if an allocation has failed, true - otherwise.
  */
-static void updateRecommendedRoomValues(int* min, Room* best_room,
-TechnionFaculty* best_faculty, int score, Room room, TechnionFaculty faculty) {
-	assert(best_room && room);
-	*min = score;
-	*best_room = room;
-	*best_faculty = faculty;
+static bool reserveView(EscapeTechnion sys) {
+	assert(sys);
+	if(!(sys->spare_view))
+		sys->spare_view = malloc(sizeof(*(sys->spare_view)));
+	return (sys->spare_view != NULL);
 }
 
 /*
- * Gets a number and returns the amount of digits in it (0 has one digit)
+ * Publishes the system's current earnings as the latest view. There must be a
+ * reserved view. The spare view isn't reachable by any reader, so it's filled
+ * without the lock, and only the pointer to the latest view is changed under
+ * it, so readers are never waited for.
  */
-static int numDigits(int num) {
-	int digits=0;
-	while(num) {
-		num/=10;
-		digits++;
+static void publishView(EscapeTechnion sys) {
+	assert(sys && sys->spare_view);
+	EarningsView* view = sys->spare_view;
+	view->days_passed = sys->days_passed;
+	view->total_earns = sys->total_earns;
+	for(int i=0; i<(int)UNKNOWN; i++) {
+		view->ranking[i] = sys->faculty_ranking[i];
+		view->faculty_earns[i] = sys->faculty_earns[i];
 	}
-	return ((digits == 0) ? 1 : digits);
+	view->readers = 0;
+	view->retired = false;
+	pthread_mutex_lock(&(sys->view_lock));
+	EarningsView* previous = sys->earnings_view;
+	//Every field of the view is written before this store.
+	__atomic_store_n(&(sys->earnings_view), view, __ATOMIC_RELEASE);
+	sys->spare_view = NULL;
+	if(previous && (previous->readers == 0))
+		sys->spare_view = previous;
+	else if(previous)
+		previous->retired = true;
+	pthread_mutex_unlock(&(sys->view_lock));
+}
+
+/*
+ * Pins the latest view of the earnings, so it isn't freed while it's read.
+ */
+static EarningsView* pinView(EscapeTechnion sys) {
+	assert(sys);
+	pthread_mutex_lock(&(sys->view_lock));
+	//Pairs with the store in publishView, so the view's fields are read after
+	//they were written.
+	EarningsView* view = __atomic_load_n(&(sys->earnings_view),
+	__ATOMIC_ACQUIRE);
+	(view->readers)++;
+	pthread_mutex_unlock(&(sys->view_lock));
+	return view;
 }
 
 /*
- * Writes the days and hour fields into a string, with a '-' delimeter.
+ * Releases a pinned view. If a newer view was published since it was pinned,
+ * its last reader frees it.
  */
-static void fillDate(char *date, int days, int hour) {
-	sprintf(date, "%d%c%d" , days, SEPARATE_FIELDS, hour);
+static void releaseView(EscapeTechnion sys, EarningsView* view) {
+	assert(sys && view);
+	pthread_mutex_lock(&(sys->view_lock));
+	bool last_reader = (--(view->readers) == 0) && (view->retired);
+	pthread_mutex_unlock(&(sys->view_lock));
+	if(last_reader)
+		free(view);
 }
 
 /*
- * Updates the days-hour combination to be the very next hour that's valid for
- * the room (if we've reached the close time of a room - we have to move to
- * the next day!)
+ * Checks if a faculty should be ranked before another faculty: a faculty that
+ * earned more comes first, and on a tie - the faculty with the lower number.
  */
-static void dateNextRoomHour(Room room, char* date, int days, int hour) {
-	assert(room && date);
-	int open_time=0, close_time=0;
-	roomGetOpenTime(room, &open_time);
-	roomGetCloseTime(room, &close_time);
-	if(hour == close_time-1) {
-		hour = open_time;
-		days++;
+static bool facultyRanksBefore(EscapeTechnion sys, TechnionFaculty faculty1,
+TechnionFaculty faculty2) {
+	assert(sys);
+	int earns1 = sys->faculty_earns[faculty1],
+	earns2 = sys->faculty_earns[faculty2];
+	return ((earns1 > earns2) || ((earns1 == earns2) && (faculty1 < faculty2)));
+}
+
+/*
+ * Adds an amount of money (can be negative) to the revenue of a faculty and to
+ * the system's total revenue. The faculty is then moved to its new place in
+ * the ranking of the faculties, so the ranking is always sorted.
+ */
+static void systemUpdateEarns(EscapeTechnion sys, TechnionFaculty faculty,
+int amount) {
+	assert(sys && (faculty >= 0) && (faculty < UNKNOWN));
+	sys->faculty_earns[faculty] += amount;
+	sys->total_earns += amount;
+	int place = 0;
+	while(sys->faculty_ranking[place] != faculty)
+		place++;
+	while((place > 0) && facultyRanksBefore(sys, faculty,
+	sys->faculty_ranking[place-1])) {
+		//The faculty earned more than the one before it. They switch places.
+		sys->faculty_ranking[place] = sys->faculty_ranking[place-1];
+		sys->faculty_ranking[--place] = faculty;
+	}
+	while((place < (int)UNKNOWN-1) && facultyRanksBefore(sys,
+	sys->faculty_ranking[place+1], faculty)) {
+		//The faculty lost money, and the one after it is better now.
+		sys->faculty_ranking[place] = sys->faculty_ranking[place+1];
+		sys->faculty_ranking[++place] = faculty;
 	}
-	fillDate(date, days, hour);
 }
 
 /*
- * Returns the amount of reservations in the system that are scheduled for today
+ * Adds a company to the system's set of companies, and makes it the owner of
+ * its (interned) email in the system's email index. The system takes
+ * ownership of the company: if the function fails - the company is destroyed, and
+ * its email is removed from the index.
  */
-static int systemTodaysReservations(EscapeTechnion sys) {
-	int reservations_amount = 0;
-	SET_FOREACH(Company, company, sys->companies)
-		reservations_amount+=companyTodaysReservations(company);
-	return reservations_amount;
+static EscapeTechnionResult systemAddCompany(EscapeTechnion sys,
+Company company) {
+	assert(sys && company);
+	int email_id = 0;
+	companyGetEmailId(company, &email_id);
+	EmailIndexResult index_result = emailIndexAdd(sys->emails, email_id,
+	EMAIL_OWNER_COMPANY, company);
+	if(index_result != EMAIL_INDEX_SUCCESS) {
+		companyDestroy(company);
+		return (index_result == EMAIL_INDEX_OUT_OF_MEMORY) ?
+		(ESCAPE_TECHNION_OUT_OF_MEMORY) : (ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS);
+	}
+	if(companyIndexRooms(company, sys->rooms) != COMPANY_SUCCESS) {
+		companyUnindexRooms(company, sys->rooms);
+		emailIndexRemove(sys->emails, email_id);
+		companyDestroy(company);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	if(setAdd(sys->companies, company) != SET_SUCCESS) {
+		//The index already says the email is new, so it's a memory problem.
+		companyUnindexRooms(company, sys->rooms);
+		emailIndexRemove(sys->emails, email_id);
+		companyDestroy(company);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	return ESCAPE_TECHNION_SUCCESS;
 }
 
 /*
- * A reservation was sent to be printed, all of its data is here: the company
- * to which the room belongs, the room itself and the reservation.
- * We decipher all the relevant data for the print function thanks to the
- * ADT's getter functions, and send all of the data to be printed.
+ * Adds an escaper to the system's set of escapers, and makes it the owner of
+ * its (interned) email in the system's email index. The system takes
+ * ownership of the escaper: if the function fails - the escaper is destroyed, and
+ * its email is removed from the index.
  */
-static void printReservation(EscapeTechnion sys, Company company,
-Room room, Reservation reservation) {
-	assert(sys && company && room && reservation);
-	char* escaper_email = NULL;
-	char* company_email = NULL;
-	TechnionFaculty escaper_faculty=UNKNOWN, room_faculty=UNKNOWN;
-	int escaper_skill=0, room_id=0, reservation_hour=0,
-	reservation_participants=0, reservation_price=0, room_difficulty=0;
-	companyGetEmail(company, &company_email);
-	reservationGetEscaperEmail(reservation, &escaper_email);
-	Escaper escaper = getEscaperByEmail(sys, escaper_email);
-	assert(escaper);
-	escaperGetSkillLevel(escaper, &escaper_skill);
-	escaperGetFaculty(escaper, &escaper_faculty);
-	companyGetFaculty(company, &room_faculty);
-	roomGetId(room, &room_id);
-	roomGetDifficulty(room, &room_difficulty);
-	reservation_hour = reservationGetHour(reservation);
-	reservation_participants = reservationGetPeople(reservation);
-	reservation_price = reservationGetPrice(reservation);
-	mtmPrintOrder(sys->output_channel, escaper_email, escaper_skill,
-	escaper_faculty, company_email, room_faculty, room_id, reservation_hour,
-	room_difficulty, reservation_participants, reservation_price);
-	reservationInvalidate(reservation);
+static EscapeTechnionResult systemAddEscaper(EscapeTechnion sys,
+Escaper escaper) {
+	assert(sys && escaper);
+	int email_id = 0;
+	escaperGetEmailId(escaper, &email_id);
+	EmailIndexResult index_result = emailIndexAdd(sys->emails, email_id,
+	EMAIL_OWNER_ESCAPER, escaper);
+	if(index_result != EMAIL_INDEX_SUCCESS) {
+		escaperDestroy(escaper);
+		return (index_result == EMAIL_INDEX_OUT_OF_MEMORY) ?
+		(ESCAPE_TECHNION_OUT_OF_MEMORY) : (ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS);
+	}
+	if(setAdd(sys->escapers, escaper) != SET_SUCCESS) {
+		emailIndexRemove(sys->emails, email_id);
+		escaperDestroy(escaper);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
+/*
+ * The escaper makes a reservation to a room (of the given faculty), and the
+ * new reservation is added to the system's calendar.
+ * #return:
+ * 	The escaper's result of making the reservation. If the reservation couldn't
+ * 	be added to the calendar, it's cancelled and ESCAPER_OUT_OF_MEMORY is
+ * 	returned.
+ */
+static EscaperResult systemMakeReservation(EscapeTechnion sys,
+Escaper escaper, Room room, TechnionFaculty faculty, int num_ppl, int day,
+int hour) {
+	assert(sys && escaper && room);
+	Reservation reservation = NULL;
+	Company company = NULL;
+	int id = 0;
+	roomGetId(room, &id);
+	roomIndexFind(sys->rooms, faculty, id, &company);
+	EscaperResult result = escaperMakeReservation(escaper,
+	sys->reservation_pool, room, faculty, num_ppl, day, hour, &reservation);
+	CHECK_VALID((result == ESCAPER_SUCCESS), result)
+	pthread_mutex_lock(&(sys->calendar_lock));
+	CalendarResult calendar_result = calendarAdd(sys->calendar, reservation,
+	room, company);
+	pthread_mutex_unlock(&(sys->calendar_lock));
+	if(calendar_result != CALENDAR_SUCCESS) {
+		int time = reservationGetTime(reservation);
+		escaperRemoveReservation(escaper, time);
+		roomRemoveReservation(room, time);
+		return ESCAPER_OUT_OF_MEMORY;
+	}
+	companyUpdateReservations(company, 1);
+	return ESCAPER_SUCCESS;
 }
 
 /*
- * Gets two arrays: array of the earns of all faculties(faculties sorted by
- * indexes), and an array of the top (3) faculties. Updates the top faculties
- * array: each member holds the desired faculty, from best to worst according to
- * indexes order. The faculty earns array is left unchanged.
+ * Adds every reservation in the system's rooms to the orders of the escaper
+ * who made it (used when a system is copied, since escapers are copied
+ * without their reservations).
+ * #return:
+ * 	false - if an allocation has failed, true - otherwise.
  */
-static void systemFillTopFaculties(EscapeTechnion sys, int faculty_earns[],
-TechnionFaculty best_faculties[]) {
-	int max = 0;
-	TechnionFaculty desired_faculty=UNKNOWN;
-	int temporary_earns[BEST_FACULTIES_AMOUNT] = {0};
-	for(int i=0; i<BEST_FACULTIES_AMOUNT; i++) {
-		for(int curr_faculty = 0; curr_faculty<(int)UNKNOWN; curr_faculty++) {
-			if(faculty_earns[curr_faculty] > max) {
-				max = faculty_earns[curr_faculty];
-				desired_faculty = (TechnionFaculty)curr_faculty;
+static bool systemLinkReservations(EscapeTechnion sys) {
+	assert(sys);
+	SET_FOREACH(Company, company, sys->companies) {
+		COMPANY_FOREACH(room, company) {
+			ROOM_FOREACH(reservation, room) {
+				if(escaperAddReservation(getEscaperById(sys,
+				reservationGetEscaperId(reservation)), room, reservation) !=
+				ESCAPER_SUCCESS)
+					return false;
 			}
 		}
-		best_faculties[i] = desired_faculty;
-		temporary_earns[i] = max;
-		max = -1;
-		faculty_earns[(int)desired_faculty] = -1;
 	}
-	for(int i=0; i<BEST_FACULTIES_AMOUNT; i++)
-		faculty_earns[best_faculties[i]] = temporary_earns[i];
+	return true;
 }
 
 EscapeTechnion escapeTechnionCreate() {
@@ -512,8 +698,40 @@ EscapeTechnion escapeTechnionCreate() {
 		free(sys);
 		return NULL;
 	}
+	sys->emails = emailIndexCreate();
+	sys->rooms = roomIndexCreate();
+	sys->calendar = calendarCreate(0);
+	sys->reservation_pool = poolCreate(NULL, reservationSize());
+	if(!(sys->emails) || !(sys->rooms) || !(sys->calendar) ||
+	!(sys->reservation_pool)) {
+		emailIndexDestroy(sys->emails);
+		roomIndexDestroy(sys->rooms);
+		calendarDestroy(sys->calendar);
+		poolDestroy(sys->reservation_pool);
+		setDestroy(sys->escapers);
+		setDestroy(sys->companies);
+		free(sys);
+		return NULL;
+	}
 	sys->days_passed = 0;
+	sys->total_earns = 0;
+	for(int i=0; i<(int)UNKNOWN; i++) {
+		sys->faculty_earns[i] = 0;
+		sys->faculty_ranking[i] = (TechnionFaculty)i;
+	}
 	sys->output_channel = stdout;
+	sys->report_writer = NULL;
+	sys->report_workers = 1;
+	sys->part_writers = NULL;
+	sys->earnings_view = NULL;
+	sys->spare_view = NULL;
+	pthread_mutex_init(&(sys->view_lock), NULL);
+	pthread_mutex_init(&(sys->calendar_lock), NULL);
+	if(!reserveView(sys)) {
+		escapeTechnionDestroy(sys);
+		return NULL;
+	}
+	publishView(sys);
 	return sys;
 }
 
@@ -521,19 +739,61 @@ EscapeTechnion escapeTechnionCopy(EscapeTechnion sys) {
 	CHECK_VALID(sys, NULL)
 	EscapeTechnion sys_copy = escapeTechnionCreate();
 	CHECK_VALID(sys_copy, NULL)
-	sys_copy->companies = setCopy(sys->companies);
-	if(!(sys_copy->companies)) {
-		free(sys_copy);
+	//The copy's calendar has to start from the same day as the original's.
+	calendarDestroy(sys_copy->calendar);
+	sys_copy->calendar = calendarCreate(sys->days_passed);
+	if(!(sys_copy->calendar)) {
+		escapeTechnionDestroy(sys_copy);
 		return NULL;
 	}
-	sys_copy->escapers = setCopy(sys->escapers);
-	if(!(sys_copy->escapers)) {
-		setDestroy(sys->companies);
-		free(sys_copy);
+	//The copied entities keep the ids of their emails, so the copy's email
+	//index has to give out the same ids as the original's.
+	emailIndexDestroy(sys_copy->emails);
+	sys_copy->emails = emailIndexCopy(sys->emails);
+	if(!(sys_copy->emails)) {
+		escapeTechnionDestroy(sys_copy);
+		return NULL;
+	}
+	//The sets own their elements, so we copy them one by one.
+	SET_FOREACH(Company, company, sys->companies) {
+		Company company_copy = companyCopy(company);
+		if((!company_copy) || (systemAddCompany(sys_copy, company_copy) !=
+		ESCAPE_TECHNION_SUCCESS) || (companyScheduleReservations(company_copy,
+		sys_copy->calendar) != COMPANY_SUCCESS)) {
+			escapeTechnionDestroy(sys_copy);
+			return NULL;
+		}
+	}
+	SET_FOREACH(Escaper, escaper, sys->escapers) {
+		Escaper escaper_copy = escaperCopy(escaper);
+		if((!escaper_copy) || (systemAddEscaper(sys_copy, escaper_copy) !=
+		ESCAPE_TECHNION_SUCCESS)) {
+			escapeTechnionDestroy(sys_copy);
+			return NULL;
+		}
+	}
+	if(!systemLinkReservations(sys_copy)) {
+		escapeTechnionDestroy(sys_copy);
 		return NULL;
 	}
 	sys_copy->days_passed = sys->days_passed;
+	sys_copy->total_earns = sys->total_earns;
+	for(int i=0; i<(int)UNKNOWN; i++) {
+		sys_copy->faculty_earns[i] = sys->faculty_earns[i];
+		sys_copy->faculty_ranking[i] = sys->faculty_ranking[i];
+	}
+	if(!reserveView(sys_copy)) {
+		escapeTechnionDestroy(sys_copy);
+		return NULL;
+	}
+	publishView(sys_copy);
 	sys_copy->output_channel = sys->output_channel;
+	if((sys->report_writer && (escapeTechnionSetBufferedOutput(sys_copy, true)
+	!= ESCAPE_TECHNION_SUCCESS)) || (escapeTechnionSetReportWorkers(sys_copy,
+	sys->report_workers) != ESCAPE_TECHNION_SUCCESS)) {
+		escapeTechnionDestroy(sys_copy);
+		return NULL;
+	}
 	return sys_copy;
 }
 
@@ -541,17 +801,76 @@ EscapeTechnionResult escapeTechnionModifyOutput(EscapeTechnion sys,
 FILE* output_file) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(output_file, ESCAPE_TECHNION_NULL_PARAMETER)
+	if(sys->report_writer)
+		reportWriterSetChannel(sys->report_writer, output_file);
 	if(sys->output_channel != stdout)
 		fclose(sys->output_channel);
 	sys->output_channel = output_file;
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
+EscapeTechnionResult escapeTechnionSetBufferedOutput(EscapeTechnion sys,
+bool buffered) {
+	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
+	if(!buffered) {
+		//Without a buffer, the reports can only be printed by one thread.
+		destroyPartWriters(sys);
+		sys->report_workers = 1;
+		reportWriterDestroy(sys->report_writer);
+		sys->report_writer = NULL;
+		return ESCAPE_TECHNION_SUCCESS;
+	}
+	if(!(sys->report_writer))
+		sys->report_writer = reportWriterCreate(sys->output_channel);
+	CHECK_VALID(sys->report_writer, ESCAPE_TECHNION_OUT_OF_MEMORY)
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
+EscapeTechnionResult escapeTechnionSetReportWorkers(EscapeTechnion sys,
+int workers) {
+	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
+	CHECK_VALID(((workers >= 1) && (workers <= MAX_REPORT_WORKERS)),
+	ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID((workers != sys->report_workers), ESCAPE_TECHNION_SUCCESS)
+	ReportWriter* part_writers = NULL;
+	if(workers > 1) {
+		CHECK_VALID((escapeTechnionSetBufferedOutput(sys, true) ==
+		ESCAPE_TECHNION_SUCCESS), ESCAPE_TECHNION_OUT_OF_MEMORY)
+		part_writers = malloc((workers-1) * sizeof(*part_writers));
+		CHECK_VALID(part_writers, ESCAPE_TECHNION_OUT_OF_MEMORY)
+		for(int i=0; i<workers-1; i++) {
+			//The parts are only added to the report's writer.
+			part_writers[i] = reportWriterCreate(NULL);
+			if(!(part_writers[i])) {
+				for(int j=0; j<i; j++)
+					reportWriterDestroy(part_writers[j]);
+				free(part_writers);
+				return ESCAPE_TECHNION_OUT_OF_MEMORY;
+			}
+		}
+	}
+	destroyPartWriters(sys);
+	sys->part_writers = part_writers;
+	sys->report_workers = workers;
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
 
 EscapeTechnionResult escapeTechnionDestroy(EscapeTechnion sys) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
+	emailIndexDestroy(sys->emails);
+	roomIndexDestroy(sys->rooms);
+	calendarDestroy(sys->calendar);
 	setDestroy(sys->companies);
 	setDestroy(sys->escapers);
+	//Only now, after the rooms have given their reservations back to it.
+	poolDestroy(sys->reservation_pool);
+	destroyPartWriters(sys);
+	reportWriterDestroy(sys->report_writer);
+	free(sys->earnings_view);
+	free(sys->spare_view);
+	pthread_mutex_destroy(&(sys->view_lock));
+	pthread_mutex_destroy(&(sys->calendar_lock));
 	free(sys);
 	return ESCAPE_TECHNION_SUCCESS;
 }
@@ -560,37 +879,41 @@ EscapeTechnionResult escapeTechnionAddCompany(EscapeTechnion sys, char* email,
 TechnionFaculty faculty) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID(((faculty>=0) && (faculty<UNKNOWN)),
 	ESCAPE_TECHNION_INVALID_PARAMETER)
-	char* target_email = NULL;
-	SET_FOREACH(Escaper, escaper, sys->escapers) {
-		assert(escaper);
-		escaperGetEmail(escaper, &target_email);
-		if(strcmp(email, target_email) == 0)
-			return ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS;
-	}
-	Company new_company = companyCreate(NULL, email, faculty);
-	CHECK_VALID(new_company, ESCAPE_TECHNION_OUT_OF_MEMORY)
-	SetResult result = setAdd(sys->companies, new_company);
-	companyDestroy(new_company);
-	if(result != SET_SUCCESS) {
-		return(result == SET_OUT_OF_MEMORY) ? (ESCAPE_TECHNION_OUT_OF_MEMORY) :
-		(ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS);
+	CHECK_VALID((emailIndexGetId(sys->emails, email) == EMAIL_INDEX_NO_ID),
+	ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS)
+	//The email is only interned once we know it's new.
+	int email_id = EMAIL_INDEX_NO_ID;
+	CHECK_VALID((emailIndexIntern(sys->emails, email, &email_id) ==
+	EMAIL_INDEX_SUCCESS), ESCAPE_TECHNION_OUT_OF_MEMORY)
+	Company new_company = companyCreate(NULL, email_id, faculty);
+	if(!new_company) {
+		emailIndexRemove(sys->emails, email_id);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
 	}
-	return ESCAPE_TECHNION_SUCCESS;
+	return systemAddCompany(sys, new_company);
 }
 
 EscapeTechnionResult escapeTechnionRemoveCompany(EscapeTechnion sys,
 char* email) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
 	Company to_remove = getCompanyByEmail(sys, email);
 	CHECK_VALID(to_remove, ESCAPE_TECHNION_COMPANY_EMAIL_DOES_NOT_EXIST)
 	if(companyRoomsReserved(to_remove))
 		return ESCAPE_TECHNION_RESERVATION_EXISTS;
+	CHECK_VALID(reserveView(sys), ESCAPE_TECHNION_OUT_OF_MEMORY)
+	//The revenue of the company's rooms leaves the system with them.
+	TechnionFaculty faculty = UNKNOWN;
+	companyGetFaculty(to_remove, &faculty);
+	systemUpdateEarns(sys, faculty, -companyEarns(to_remove));
+	companyUnindexRooms(to_remove, sys->rooms);
+	emailIndexRemove(sys->emails, emailIndexGetId(sys->emails, email));
 	setRemove(sys->companies, to_remove);
+	publishView(sys);
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
@@ -598,27 +921,24 @@ EscapeTechnionResult escapeTechnionAddRoom(EscapeTechnion sys, char* email,
 int id, int price, int num_ppl, char* working_hours, int difficulty) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
-	CHECK_VALID(checkRoomParameters(id, price, num_ppl, difficulty,
-	working_hours), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	//The working hours are read here once, and the room gets their values.
+	int open = 0, close = 0;
+	CHECK_VALID((fieldReadHours(working_hours, &open, &close) &&
+	checkRoomParameters(id, price, num_ppl, difficulty, open, close)),
+	ESCAPE_TECHNION_INVALID_PARAMETER)
 	Company target_company = getCompanyByEmail(sys, email);
 	CHECK_VALID(target_company, ESCAPE_TECHNION_COMPANY_EMAIL_DOES_NOT_EXIST);
-	TechnionFaculty target_faculty = UNKNOWN, company_faculty = UNKNOWN;
-	Room room = NULL;
-	companyGetFaculty(target_company, &target_faculty);
-	SET_FOREACH(Company, company, sys->companies) {
-		assert(company);
-		companyGetFaculty(company, &company_faculty);
-		if(target_faculty == company_faculty) {
-			companyGetRoom(company, &room, id);
-			if(room)
-				return ESCAPE_TECHNION_ID_ALREADY_EXIST;
-		}
+	switch(companyNewRoom(target_company, sys->rooms, id, price, num_ppl,
+	difficulty, open, close)) {
+		case COMPANY_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		case COMPANY_ROOM_ID_EXISTS:
+			//The room index found that id in the company's faculty.
+			return ESCAPE_TECHNION_ID_ALREADY_EXIST;
+		default:
+			return ESCAPE_TECHNION_SUCCESS;
 	}
-	if(companyNewRoom(target_company, id, price, num_ppl, difficulty,
-	working_hours) == COMPANY_OUT_OF_MEMORY)
-		return ESCAPE_TECHNION_OUT_OF_MEMORY;
-	return ESCAPE_TECHNION_SUCCESS;
 }
 
 EscapeTechnionResult escapeTechnionRemoveRoom(EscapeTechnion sys,
@@ -629,8 +949,15 @@ TechnionFaculty faculty, int id) {
 	CHECK_VALID((id>0), ESCAPE_TECHNION_INVALID_PARAMETER)
 	Company desired_company = getCompanyByRoomId(sys, faculty, id);
 	CHECK_VALID(desired_company, ESCAPE_TECHNION_ID_DOES_NOT_EXIST)
-	if(companyRemoveRoom(desired_company, id) == COMPANY_ROOM_HAS_RESERVATIONS)
+	int room_earns = 0;
+	roomEarns(getFacultyRoomById(sys, id, faculty), &room_earns);
+	CHECK_VALID(reserveView(sys), ESCAPE_TECHNION_OUT_OF_MEMORY)
+	if(companyRemoveRoom(desired_company, sys->rooms, id) ==
+	COMPANY_ROOM_HAS_RESERVATIONS)
 		return ESCAPE_TECHNION_RESERVATION_EXISTS;
+	//The revenue of the room leaves the system with it.
+	systemUpdateEarns(sys, faculty, -room_earns);
+	publishView(sys);
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
@@ -638,41 +965,50 @@ EscapeTechnionResult escapeTechnionAddEscaper(EscapeTechnion sys, char* email,
 TechnionFaculty faculty, int skill_level) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID(((faculty>=0) && (faculty<UNKNOWN)),
 	ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID(((skill_level > 0) && (skill_level<=MAX_LEVEL)),
 	ESCAPE_TECHNION_INVALID_PARAMETER)
-	char* target_email = NULL;
-	SET_FOREACH(Company, company, sys->companies) {
-		assert(company);
-		companyGetEmail(company, &target_email);
-		if(strcmp(email, target_email) == 0)
-			return ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS;
-	}
-	Escaper new_escaper = escaperCreate(NULL, email, faculty, skill_level);
-	CHECK_VALID(new_escaper, ESCAPE_TECHNION_OUT_OF_MEMORY)
-	SetResult result = setAdd(sys->escapers, new_escaper);
-	escaperDestroy(new_escaper);
-	if(result != SET_SUCCESS) {
-		return(result == SET_OUT_OF_MEMORY) ? (ESCAPE_TECHNION_OUT_OF_MEMORY) :
-		(ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS);
+	CHECK_VALID((emailIndexGetId(sys->emails, email) == EMAIL_INDEX_NO_ID),
+	ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS)
+	//The email is only interned once we know it's new.
+	int email_id = EMAIL_INDEX_NO_ID;
+	CHECK_VALID((emailIndexIntern(sys->emails, email, &email_id) ==
+	EMAIL_INDEX_SUCCESS), ESCAPE_TECHNION_OUT_OF_MEMORY)
+	Escaper new_escaper = escaperCreate(NULL, email_id, faculty, skill_level);
+	if(!new_escaper) {
+		emailIndexRemove(sys->emails, email_id);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
 	}
-	return ESCAPE_TECHNION_SUCCESS;
+	return systemAddEscaper(sys, new_escaper);
 }
 
 EscapeTechnionResult escapeTechnionRemoveEscaper(EscapeTechnion sys,
 char* email) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID(fieldIsEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
 	Escaper to_remove = getEscaperByEmail(sys, email);
 	CHECK_VALID(to_remove, ESCAPE_TECHNION_CLIENT_EMAIL_DOES_NOT_EXIST)
-	int id = 0;
-	SET_FOREACH(Company, company, sys->companies)
-		COMPANY_FOREACH(room, company, id)
-			roomRemoveEscaperReservations(room, email);
-	setRemove(sys->companies, to_remove);
+	//Only the rooms the escaper has ordered are visited.
+	int amount = 0, id = 0;
+	Room room = NULL;
+	Company company = NULL;
+	escaperReservationsAmount(to_remove, &amount);
+	for(int i=0; i<amount; i++) {
+		Reservation reservation = escaperGetReservation(to_remove, i, &room);
+		roomGetId(room, &id);
+		roomIndexFind(sys->rooms, reservationGetFaculty(reservation), id,
+		&company);
+		companyUpdateReservations(company, -1);
+		//The calendar reads the reservation, so it's removed before the room
+		//destroys it.
+		calendarRemove(sys->calendar, reservation);
+		roomRemoveReservation(room, reservationGetTime(reservation));
+	}
+	emailIndexRemove(sys->emails, emailIndexGetId(sys->emails, email));
+	setRemove(sys->escapers, to_remove);
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
@@ -681,7 +1017,7 @@ TechnionFaculty faculty, int id, char* time, int num_ppl) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
 	CHECK_VALID(time, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID((isLegalEmail(email)), ESCAPE_TECHNION_INVALID_PARAMETER)
+	CHECK_VALID((fieldIsEmail(email)), ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID((id >= 0), ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID((num_ppl > 0), ESCAPE_TECHNION_INVALID_PARAMETER)
 	CHECK_VALID(((faculty>=0)&&(faculty<UNKNOWN)),
@@ -690,19 +1026,25 @@ TechnionFaculty faculty, int id, char* time, int num_ppl) {
 	CHECK_VALID(desired_escaper, ESCAPE_TECHNION_CLIENT_EMAIL_DOES_NOT_EXIST)
 	Room desired_room = getFacultyRoomById(sys, id, faculty);
 	CHECK_VALID(desired_room, ESCAPE_TECHNION_ID_DOES_NOT_EXIST)
-	int room_open=0, room_close=0;
-	roomGetOpenTime(desired_room, &room_close);
+	int room_open=0, room_close=0, days=0, hour=0;
+	roomGetOpenTime(desired_room, &room_open);
 	roomGetCloseTime(desired_room, &room_close);
-	CHECK_VALID((checkReservationTime(time, room_open, room_close)),
+	CHECK_VALID((checkReservationTime(time, room_open, room_close, &days,
+	&hour)), ESCAPE_TECHNION_INVALID_PARAMETER)
+	//The days of the order are counted from today, and the day they lead to
+	//can't be later than the last day a reservation can be for.
+	CHECK_VALID((days <= RESERVATION_LAST_DAY - sys->days_passed),
 	ESCAPE_TECHNION_INVALID_PARAMETER)
 	EscaperResult order_result;
-	order_result = escaperMakeReservation(desired_escaper, desired_room,
-	faculty, num_ppl, time);
+	order_result = systemMakeReservation(sys, desired_escaper, desired_room,
+	faculty, num_ppl, sys->days_passed + days, hour);
 	switch(order_result) {
 	//There are multiple possibilities here. We return the correct error.
 		case ESCAPER_OUT_OF_MEMORY:
 			return ESCAPE_TECHNION_OUT_OF_MEMORY;
 			break;
+		case ESCAPER_INVALID_PARAMETER:
+			return ESCAPE_TECHNION_INVALID_PARAMETER;
 		case ESCAPER_IN_ROOM:
 			return ESCAPE_TECHNION_CLIENT_IN_ROOM;
 		case ESCAPER_RESERVED_ROOM:
@@ -712,111 +1054,413 @@ TechnionFaculty faculty, int id, char* time, int num_ppl) {
 	}
 }
 
+EscapeTechnionResult escapeTechnionRecommendedRoom(EscapeTechnion sys,
+char* email, int num_ppl, TechnionFaculty* faculty, int* id) {
+	CHECK_VALID(faculty && id, ESCAPE_TECHNION_NULL_PARAMETER)
+	Escaper escaper = NULL;
+	Room room = NULL;
+	EscapeTechnionResult result = findRecommendation(sys, email, num_ppl,
+	&escaper, &room, faculty);
+	CHECK_VALID((result == ESCAPE_TECHNION_SUCCESS), result)
+	roomGetId(room, id);
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
 EscapeTechnionResult escapeTechnionEscaperRecommend(EscapeTechnion sys,
 char* email, int num_ppl) {
-	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(email, ESCAPE_TECHNION_NULL_PARAMETER)
-	CHECK_VALID(isLegalEmail(email), ESCAPE_TECHNION_INVALID_PARAMETER)
-	CHECK_VALID(((num_ppl)>0),ESCAPE_TECHNION_INVALID_PARAMETER)
-	int skill_level = 0, room_id = 0, days = 0, hour = 0;
-	TechnionFaculty escaper_faculty = UNKNOWN, room_faculty = UNKNOWN;
-	Escaper escaper = getEscaperByEmail(sys, email);
-	if(!escaper)
-		return ESCAPE_TECHNION_CLIENT_EMAIL_DOES_NOT_EXIST;
-	escaperGetSkillLevel(escaper, &skill_level);
-	escaperGetFaculty(escaper, &escaper_faculty);
-	Room room = recommendedRoom(sys, skill_level, num_ppl, escaper_faculty,
-	&room_faculty);
-	if(!room)
-		return ESCAPE_TECHNION_NO_ROOMS_AVAILABLE;
-	roomGetId(room, &room_id);
-	//That's the earliest days-hour combination when the room isn't busy
-	roomGetEarliestTimeAvailable(room, &days, &hour);
-	int date_size = numDigits(days) + numDigits(hour) + 1;
-	char* date = malloc(sizeof(date_size)+1);
-	CHECK_VALID(date, ESCAPE_TECHNION_OUT_OF_MEMORY);
-	date[date_size] = 0;
-	fillDate(date, days, hour);
-	while(escaperIsBusy(escaper, ((hour*HOURS_IN_A_DAY) + days))) {
-		//Uh-oh! The escaper is busy at the best possible time for the room!
-		//We try the next best option again and again until we succeed.
-		dateNextRoomHour(room, date, days, hour);
-		roomGetEarliestTimeAvailable(room, &days, &hour);
-		fillDate(date, days, hour);
-	}
-	if(escaperMakeReservation(escaper, room,
-	room_faculty, num_ppl, date) != ESCAPER_SUCCESS) {
+	int days = 0, hour = 0;
+	TechnionFaculty room_faculty = UNKNOWN;
+	Escaper escaper = NULL;
+	Room room = NULL;
+	EscapeTechnionResult result = findRecommendation(sys, email, num_ppl,
+	&escaper, &room, &room_faculty);
+	CHECK_VALID((result == ESCAPE_TECHNION_SUCCESS), result)
+	//That's the earliest days-hour combination (from today on) when neither
+	//the room nor the escaper is busy. Days are absolute, just like the
+	//reservations' times.
+	Occupancy escaper_schedule = NULL;
+	escaperGetSchedule(escaper, &escaper_schedule);
+	days = sys->days_passed;
+	roomGetEarliestTimeAvailable(room, escaper_schedule, &days, &hour);
+	if(systemMakeReservation(sys, escaper, room, room_faculty, num_ppl,
+	days, hour) != ESCAPER_SUCCESS)
 		//A memory problem has occurred when we created the reservation.
-		free(date);
 		return ESCAPE_TECHNION_OUT_OF_MEMORY;
-	}
-	free(date);
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
 EscapeTechnionResult escapeTechnionReportDay(EscapeTechnion sys) {
 	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
-	int id=0, total_res = systemTodaysReservations(sys);
-	mtmPrintDayHeader(sys->output_channel, sys->days_passed, total_res);
-	TechnionFaculty faculty;
-	Reservation curr_reservation;
-	for(int curr_time = 0; curr_time<HOURS_IN_A_DAY; curr_time++) {
-	//We iterate over all the possible hours, from 0 to 23...
-		for(TechnionFaculty curr_faculty = 0; curr_faculty<UNKNOWN;
-		//We iterate over all the possible faculties, from lowest to highest...
-		curr_faculty++) {
-			SET_FOREACH(Company, curr_company, sys->companies) {
-				//We iterate over all the companies in the system...
-				companyGetFaculty(curr_company, &faculty);
-				if(faculty == curr_faculty) {
-					//We found a company of the desired faculty!
-					COMPANY_FOREACH(curr_room, curr_company, id) {
-						//We iterate over all the rooms in the company
-						//(iteration is performed from lowest id to highest)
-						curr_reservation = roomGetReservationInTime
-						(curr_room, curr_time);
-						if(reservationIsValid(curr_reservation)) {
-							//We found a reservation that's for this hour and
-							//belongs to this room. We send it to be printed.
-							printReservation(sys, curr_company, curr_room,
-							curr_reservation);
-						}
-					}
-				}
-			}
+	int today = sys->days_passed,
+	total_res = calendarDayReservations(sys->calendar, today);
+	CHECK_VALID(reserveView(sys), ESCAPE_TECHNION_OUT_OF_MEMORY)
+	//The report is printed as a whole, even if another thread prints the
+	//best faculties at the same time.
+	flockfile(sys->output_channel);
+	if(sys->report_writer)
+		reportWriterDayHeader(sys->report_writer, today, total_res);
+	else
+		mtmPrintDayHeader(sys->output_channel, today, total_res);
+	//Today's bucket is already sorted by hour, then by faculty and then by
+	//room id, so we print the reservations one after the other.
+	printDayReservations(sys, today, total_res);
+	if(sys->report_writer) {
+		//The whole report goes out with one write.
+		reportWriterDayFooter(sys->report_writer, today);
+		reportWriterFlush(sys->report_writer);
+	}
+	else
+		mtmPrintDayFooter(sys->output_channel, today);
+	funlockfile(sys->output_channel);
+	//Only the rooms that were reserved today have reservations to fulfill.
+	//Their revenue goes straight to their faculty.
+	Room curr_room = NULL;
+	Company curr_company = NULL;
+	for(int i = 0; i<total_res; i++) {
+		//The reservation is fulfilled, so the escaper is free at its time
+		//again. It's done before the rooms fulfill them (and destroy them).
+		Reservation curr_reservation = calendarGetReservation(sys->calendar,
+		today, i, NULL, NULL);
+		escaperRemoveReservation(getEscaperById(sys,
+		reservationGetEscaperId(curr_reservation)),
+		reservationGetTime(curr_reservation));
+	}
+	int room_earns = 0;
+	TechnionFaculty faculty = UNKNOWN;
+	for(int i = 0; i<total_res; i++) {
+		calendarGetReservation(sys->calendar, today, i, &curr_room,
+		&curr_company);
+		//The room fulfills all of today's reservations at once, but every
+		//entry of the bucket is one reservation less for its company.
+		roomNextDay(curr_room, today, &room_earns);
+		companyUpdateReservations(curr_company, -1);
+		if(room_earns > 0) {
+			companyGetFaculty(curr_company, &faculty);
+			systemUpdateEarns(sys, faculty, room_earns);
 		}
 	}
-	mtmPrintDayFooter(sys->output_channel, sys->days_passed);
-	SET_FOREACH(Company, company, sys->companies)
-		companyNextDay(company);
-	SET_FOREACH(Escaper, escaper, sys->escapers)
-		escaperNextDay(escaper);
+	calendarNextDay(sys->calendar);
 	(sys->days_passed)++;
+	publishView(sys);
 	return ESCAPE_TECHNION_SUCCESS;
 }
 
 EscapeTechnionResult escapeTechnionReportBest(EscapeTechnion sys) {
+	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
 	assert((int)UNKNOWN >= BEST_FACULTIES_AMOUNT);
-	int faculty_earns[(int)UNKNOWN] = {0};
-	int total_system_earns = 0;
-	TechnionFaculty best_faculties[BEST_FACULTIES_AMOUNT];
-	for(int i = 0; i<BEST_FACULTIES_AMOUNT; i++)
-		best_faculties[i] = i;
-	TechnionFaculty target_faculty = UNKNOWN;
-	for(int curr_faculty = 0; curr_faculty<(int)UNKNOWN; curr_faculty++){
-		SET_FOREACH(Company, company, sys->companies) {
-			companyGetFaculty(company, &target_faculty);
-			if((int)target_faculty == curr_faculty)
-				faculty_earns[curr_faculty] += companyEarns(company);
-		}
-		total_system_earns += faculty_earns[curr_faculty];
-	}
-	mtmPrintFacultiesHeader(sys->output_channel, (int)UNKNOWN, sys->days_passed,
-	total_system_earns);
-	systemFillTopFaculties(sys, faculty_earns, best_faculties);
+	//The revenues are updated whenever a day ends, and the ranking is kept
+	//sorted, so the best faculties are simply the first ones in the ranking.
+	//They're read from the latest published view, and not from the system.
+	EarningsView* view = pinView(sys);
+	flockfile(sys->output_channel);
+	mtmPrintFacultiesHeader(sys->output_channel, (int)UNKNOWN,
+	view->days_passed, view->total_earns);
 	for(int i=0; i<BEST_FACULTIES_AMOUNT; i++)
-		mtmPrintFaculty(sys->output_channel, best_faculties[i],
-		faculty_earns[((int)best_faculties[i])]);
+		mtmPrintFaculty(sys->output_channel, view->ranking[i],
+		view->faculty_earns[(int)(view->ranking[i])]);
 	mtmPrintFacultiesFooter(sys->output_channel);
+	funlockfile(sys->output_channel);
+	releaseView(sys, view);
+	return ESCAPE_TECHNION_SUCCESS;
+}
+
+/*
+ * Converts the result of a checkpoint to the system's result.
+ */
+static EscapeTechnionResult checkpointError(Checkpoint checkpoint) {
+	switch(checkpointGetResult(checkpoint)) {
+		case CHECKPOINT_SUCCESS:
+			return ESCAPE_TECHNION_SUCCESS;
+		case CHECKPOINT_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		default:
+			return ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	}
+}
+
+/*
+ * Writes a company and its rooms to a checkpoint.
+ */
+static void saveCompany(EscapeTechnion sys, Checkpoint checkpoint,
+Company company) {
+	assert(sys && checkpoint && company);
+	TechnionFaculty faculty = UNKNOWN;
+	int email_id = 0, rooms_amount = 0, id = 0, price = 0, num_ppl = 0,
+	open = 0, close = 0, difficulty = 0, earns = 0;
+	companyGetEmailId(company, &email_id);
+	char* email = emailIndexGetEmail(sys->emails, email_id);
+	companyGetFaculty(company, &faculty);
+	companyRoomsAmount(company, &rooms_amount);
+	checkpointWriteString(checkpoint, email);
+	checkpointWriteInt(checkpoint, (int)faculty);
+	checkpointWriteInt(checkpoint, rooms_amount);
+	COMPANY_FOREACH(room, company) {
+		roomGetId(room, &id);
+		roomGetPrice(room, &price);
+		roomGetRecommendedPeople(room, &num_ppl);
+		roomGetOpenTime(room, &open);
+		roomGetCloseTime(room, &close);
+		roomGetDifficulty(room, &difficulty);
+		roomEarns(room, &earns);
+		checkpointWriteInt(checkpoint, id);
+		checkpointWriteInt(checkpoint, price);
+		checkpointWriteInt(checkpoint, num_ppl);
+		checkpointWriteInt(checkpoint, open);
+		checkpointWriteInt(checkpoint, close);
+		checkpointWriteInt(checkpoint, difficulty);
+		checkpointWriteInt(checkpoint, earns);
+	}
+}
+
+/*
+ * Writes an escaper and its reservations to a checkpoint. A reservation is
+ * written as its room (faculty and id), time and amount of people - the rest
+ * of it is calculated again when it's loaded.
+ */
+static void saveEscaper(EscapeTechnion sys, Checkpoint checkpoint,
+Escaper escaper) {
+	assert(sys && checkpoint && escaper);
+	TechnionFaculty faculty = UNKNOWN;
+	int email_id = 0, skill_level = 0, reservations_amount = 0, id = 0;
+	Room room = NULL;
+	escaperGetEmailId(escaper, &email_id);
+	char* email = emailIndexGetEmail(sys->emails, email_id);
+	escaperGetFaculty(escaper, &faculty);
+	escaperGetSkillLevel(escaper, &skill_level);
+	escaperReservationsAmount(escaper, &reservations_amount);
+	checkpointWriteString(checkpoint, email);
+	checkpointWriteInt(checkpoint, (int)faculty);
+	checkpointWriteInt(checkpoint, skill_level);
+	checkpointWriteInt(checkpoint, reservations_amount);
+	for(int i=0; i<reservations_amount; i++) {
+		Reservation reservation = escaperGetReservation(escaper, i, &room);
+		roomGetId(room, &id);
+		checkpointWriteInt(checkpoint, (int)reservationGetFaculty(reservation));
+		checkpointWriteInt(checkpoint, id);
+		checkpointWriteInt(checkpoint, reservationGetDay(reservation));
+		checkpointWriteInt(checkpoint, reservationGetHour(reservation));
+		checkpointWriteInt(checkpoint, reservationGetPeople(reservation));
+	}
+}
+
+/*
+ * Reads a room from a checkpoint, and adds it to its company (which is already
+ * in the system). The room's earnings are added to its faculty's revenue.
+ */
+static EscapeTechnionResult loadRoom(EscapeTechnion sys,
+Checkpoint checkpoint, Company company, TechnionFaculty faculty) {
+	assert(sys && checkpoint && company);
+	int id = 0, price = 0, num_ppl = 0, open = 0, close = 0, difficulty = 0,
+	earns = 0;
+	checkpointReadInt(checkpoint, &id);
+	checkpointReadInt(checkpoint, &price);
+	checkpointReadInt(checkpoint, &num_ppl);
+	checkpointReadInt(checkpoint, &open);
+	checkpointReadInt(checkpoint, &close);
+	checkpointReadInt(checkpoint, &difficulty);
+	checkpointReadInt(checkpoint, &earns);
+	CHECK_VALID((checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS),
+	checkpointError(checkpoint))
+	CHECK_VALID((checkRoomParameters(id, price, num_ppl, difficulty, open,
+	close) && (earns >= 0)), ESCAPE_TECHNION_CHECKPOINT_FAILED)
+	switch(companyNewRoom(company, sys->rooms, id, price, num_ppl, difficulty,
+	open, close)) {
+		case COMPANY_SUCCESS:
+			break;
+		case COMPANY_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		default:
+			return ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	}
+	Room room = NULL;
+	companyGetRoom(company, &room, id);
+	roomSetEarns(room, earns);
+	systemUpdateEarns(sys, faculty, earns);
 	return ESCAPE_TECHNION_SUCCESS;
 }
+
+/*
+ * Reads a company and its rooms from a checkpoint, and adds them to the
+ * system.
+ */
+static EscapeTechnionResult loadCompany(EscapeTechnion sys,
+Checkpoint checkpoint) {
+	assert(sys && checkpoint);
+	char* email = NULL;
+	int faculty = 0, rooms_amount = 0;
+	checkpointReadString(checkpoint, &email);
+	checkpointReadInt(checkpoint, &faculty);
+	checkpointReadInt(checkpoint, &rooms_amount);
+	CHECK_VALID((checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS),
+	checkpointError(checkpoint))
+	CHECK_VALID((fieldIsEmail(email) && (faculty >= 0) &&
+	(faculty < (int)UNKNOWN) && (rooms_amount >= 0)),
+	ESCAPE_TECHNION_CHECKPOINT_FAILED)
+	int email_id = EMAIL_INDEX_NO_ID;
+	switch(emailIndexIntern(sys->emails, email, &email_id)) {
+		case EMAIL_INDEX_SUCCESS:
+			break;
+		case EMAIL_INDEX_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		default:
+			return ESCAPE_TECHNION_CHECKPOINT_FAILED; //A repeated email.
+	}
+	Company company = companyCreate(NULL, email_id, (TechnionFaculty)faculty);
+	if(!company) {
+		emailIndexRemove(sys->emails, email_id);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	EscapeTechnionResult result = systemAddCompany(sys, company);
+	if(result == ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS)
+		return ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	for(int i=0; (i<rooms_amount) && (result == ESCAPE_TECHNION_SUCCESS); i++)
+		result = loadRoom(sys, checkpoint, company, (TechnionFaculty)faculty);
+	return result;
+}
+
+/*
+ * Reads a reservation from a checkpoint, and makes it again for its escaper.
+ */
+static EscapeTechnionResult loadReservation(EscapeTechnion sys,
+Checkpoint checkpoint, Escaper escaper) {
+	assert(sys && checkpoint && escaper);
+	int faculty = 0, id = 0, day = 0, hour = 0, num_ppl = 0;
+	checkpointReadInt(checkpoint, &faculty);
+	checkpointReadInt(checkpoint, &id);
+	checkpointReadInt(checkpoint, &day);
+	checkpointReadInt(checkpoint, &hour);
+	checkpointReadInt(checkpoint, &num_ppl);
+	CHECK_VALID((checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS),
+	checkpointError(checkpoint))
+	CHECK_VALID(((faculty >= 0) && (faculty < (int)UNKNOWN) &&
+	(day >= sys->days_passed) && (num_ppl > 0)),
+	ESCAPE_TECHNION_CHECKPOINT_FAILED)
+	Room room = getFacultyRoomById(sys, id, (TechnionFaculty)faculty);
+	CHECK_VALID(room, ESCAPE_TECHNION_CHECKPOINT_FAILED)
+	switch(systemMakeReservation(sys, escaper, room, (TechnionFaculty)faculty,
+	num_ppl, day, hour)) {
+		case ESCAPER_SUCCESS:
+			return ESCAPE_TECHNION_SUCCESS;
+		case ESCAPER_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		default:
+			return ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	}
+}
+
+/*
+ * Reads an escaper and its reservations from a checkpoint, and adds them to
+ * the system.
+ */
+static EscapeTechnionResult loadEscaper(EscapeTechnion sys,
+Checkpoint checkpoint) {
+	assert(sys && checkpoint);
+	char* email = NULL;
+	int faculty = 0, skill_level = 0, reservations_amount = 0;
+	checkpointReadString(checkpoint, &email);
+	checkpointReadInt(checkpoint, &faculty);
+	checkpointReadInt(checkpoint, &skill_level);
+	checkpointReadInt(checkpoint, &reservations_amount);
+	CHECK_VALID((checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS),
+	checkpointError(checkpoint))
+	CHECK_VALID((fieldIsEmail(email) && (faculty >= 0) &&
+	(faculty < (int)UNKNOWN) && (skill_level > 0) &&
+	(skill_level <= MAX_LEVEL) && (reservations_amount >= 0)),
+	ESCAPE_TECHNION_CHECKPOINT_FAILED)
+	int email_id = EMAIL_INDEX_NO_ID;
+	switch(emailIndexIntern(sys->emails, email, &email_id)) {
+		case EMAIL_INDEX_SUCCESS:
+			break;
+		case EMAIL_INDEX_OUT_OF_MEMORY:
+			return ESCAPE_TECHNION_OUT_OF_MEMORY;
+		default:
+			return ESCAPE_TECHNION_CHECKPOINT_FAILED; //A repeated email.
+	}
+	Escaper escaper = escaperCreate(NULL, email_id, (TechnionFaculty)faculty,
+	skill_level);
+	if(!escaper) {
+		emailIndexRemove(sys->emails, email_id);
+		return ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	EscapeTechnionResult result = systemAddEscaper(sys, escaper);
+	if(result == ESCAPE_TECHNION_EMAIL_ALREADY_EXISTS)
+		return ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	for(int i=0; (i<reservations_amount) &&
+	(result == ESCAPE_TECHNION_SUCCESS); i++)
+		result = loadReservation(sys, checkpoint, escaper);
+	return result;
+}
+
+EscapeTechnionResult escapeTechnionSave(EscapeTechnion sys, FILE* file) {
+	CHECK_VALID(sys, ESCAPE_TECHNION_NULL_PARAMETER)
+	CHECK_VALID(file, ESCAPE_TECHNION_NULL_PARAMETER)
+	Checkpoint checkpoint = checkpointCreate(file);
+	CHECK_VALID(checkpoint, ESCAPE_TECHNION_OUT_OF_MEMORY)
+	checkpointWriteHeader(checkpoint);
+	checkpointWriteInt(checkpoint, sys->days_passed);
+	checkpointWriteInt(checkpoint, setGetSize(sys->companies));
+	SET_FOREACH(Company, company, sys->companies)
+		saveCompany(sys, checkpoint, company);
+	//Escapers come after the companies, so their rooms exist when they're
+	//loaded.
+	checkpointWriteInt(checkpoint, setGetSize(sys->escapers));
+	SET_FOREACH(Escaper, escaper, sys->escapers)
+		saveEscaper(sys, checkpoint, escaper);
+	if(fflush(file) != 0)
+		checkpointInvalidate(checkpoint);
+	EscapeTechnionResult result = checkpointError(checkpoint);
+	checkpointDestroy(checkpoint);
+	return result;
+}
+
+EscapeTechnion escapeTechnionLoad(EscapeTechnionResult* result, FILE* file) {
+	INIT_IF_EXISTS(result, ESCAPE_TECHNION_NULL_PARAMETER)
+	CHECK_VALID(file, NULL)
+	INIT_IF_EXISTS(result, ESCAPE_TECHNION_OUT_OF_MEMORY)
+	Checkpoint checkpoint = checkpointCreate(file);
+	CHECK_VALID(checkpoint, NULL)
+	EscapeTechnion sys = escapeTechnionCreate();
+	if(!sys) {
+		checkpointDestroy(checkpoint);
+		return NULL;
+	}
+	int days_passed = 0, companies_amount = 0, escapers_amount = 0;
+	checkpointReadHeader(checkpoint);
+	checkpointReadInt(checkpoint, &days_passed);
+	checkpointReadInt(checkpoint, &companies_amount);
+	EscapeTechnionResult load_result = checkpointError(checkpoint);
+	if((load_result == ESCAPE_TECHNION_SUCCESS) && ((days_passed < 0) ||
+	(companies_amount < 0)))
+		load_result = ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	if(load_result == ESCAPE_TECHNION_SUCCESS) {
+		//The calendar has to start from the image's current day.
+		calendarDestroy(sys->calendar);
+		sys->calendar = calendarCreate(days_passed);
+		sys->days_passed = days_passed;
+		if(!(sys->calendar))
+			load_result = ESCAPE_TECHNION_OUT_OF_MEMORY;
+	}
+	for(int i=0; (i<companies_amount) &&
+	(load_result == ESCAPE_TECHNION_SUCCESS); i++)
+		load_result = loadCompany(sys, checkpoint);
+	if(load_result == ESCAPE_TECHNION_SUCCESS) {
+		checkpointReadInt(checkpoint, &escapers_amount);
+		load_result = checkpointError(checkpoint);
+		if(escapers_amount < 0)
+			load_result = ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	}
+	for(int i=0; (i<escapers_amount) &&
+	(load_result == ESCAPE_TECHNION_SUCCESS); i++)
+		load_result = loadEscaper(sys, checkpoint);
+	checkpointDestroy(checkpoint);
+	if((load_result == ESCAPE_TECHNION_SUCCESS) && !reserveView(sys))
+		load_result = ESCAPE_TECHNION_OUT_OF_MEMORY;
+	if(load_result == ESCAPE_TECHNION_SUCCESS)
+		publishView(sys);
+	INIT_IF_EXISTS(result, load_result)
+	if(load_result != ESCAPE_TECHNION_SUCCESS) {
+		escapeTechnionDestroy(sys);
+		return NULL;
+	}
+	return sys;
+}
@@ -13,6 +13,10 @@
 #include "Escaper.h"
 #include "Room.h"
 #include "Company.h"
+#include "EmailIndex.h"
+#include "ReportWriter.h"
+#include "Checkpoint.h"
+#include "Field.h"
 
 typedef struct EscapeTechnion_t *EscapeTechnion; //Name of the ADT.
 
@@ -30,6 +34,7 @@ typedef enum {
 	ESCAPE_TECHNION_ROOM_NOT_AVAILABLE,
 	ESCAPE_TECHNION_RESERVATION_EXISTS,
 	ESCAPE_TECHNION_NO_ROOMS_AVAILABLE,
+	ESCAPE_TECHNION_CHECKPOINT_FAILED,
 	ESCAPE_TECHNION_SUCCESS,
 } EscapeTechnionResult;
 
@@ -64,6 +69,38 @@ EscapeTechnion escapeTechnionCopy(EscapeTechnion sys);
 EscapeTechnionResult escapeTechnionModifyOutput(EscapeTechnion sys,
 FILE* output_file);
 
+/*
+ * Selects how the day reports are printed. By default, every part of a report
+ * is printed with its mtm_ex3.h printer. With buffered output, each day's
+ * report is built in one buffer and written to the output channel at once,
+ * when the day's report is done. The text is the same either way.
+ * 	$buffered: true to build the reports in a buffer, false to use the
+ * 	printers.
+ * #return:
+ * 	ESCAPE_TECHNION_NULL_PARAMETER - If a NULL parameter was given,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed,
+ * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ */
+EscapeTechnionResult escapeTechnionSetBufferedOutput(EscapeTechnion sys,
+bool buffered);
+
+/*
+ * Selects the amount of threads that build a day's report. A day with many
+ * reservations is split into consecutive parts that are built at the same
+ * time, and then printed one after the other, so the report is the same as the
+ * report one thread builds. More than one thread needs buffered output, so
+ * it's turned on (and turning it off goes back to one thread).
+ * 	$workers: The amount of threads (1 to build the reports sequentially).
+ * #return:
+ * 	ESCAPE_TECHNION_NULL_PARAMETER - If a NULL parameter was given,
+ * 	ESCAPE_TECHNION_INVALID_PARAMETER - If the amount of threads is less than 1
+ * 	or more than 64,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed,
+ * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ */
+EscapeTechnionResult escapeTechnionSetReportWorkers(EscapeTechnion sys,
+int workers);
+
 /*
  * Deallocates a system. Destroys all the companies, rooms, reservations and
  * escapers in the system using their destroyers.
@@ -95,6 +132,7 @@ TechnionFaculty faculty);
  * 	ESCAPE_TECHNION_INVALID_PARAMETER - If an invalid parameter was given,
  * 	ESCAPE_TECHNION_COMPANY_EMAIL_DOES_NOT_EXIST - If there is no company in the
  * 	system by that email,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed,
  * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
  */
 EscapeTechnionResult escapeTechnionRemoveCompany(EscapeTechnion sys,
@@ -132,6 +170,7 @@ int id, int price, int num_ppl, char* working_hours, int difficulty);
  * 	of the faculty's companies,
  * 	ESCAPE_TECHNION_RESERVATION_EXISTS - If there are unfulfilled reservations
  * 	to this room,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed,
  * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
  */
 EscapeTechnionResult escapeTechnionRemoveRoom(EscapeTechnion sys,
@@ -171,7 +210,8 @@ char* email);
  * 	$id: The id of the desired room.
  * 	$time: The time of the reservation. Received as a string of the format
  * 	"dd-hh", where day>=0 and hour is between 0 and 23. The time has to be
- * 	within the open and close time of the desired room.
+ * 	within the open and close time of the desired room, and its day (counted
+ * 	from the system's first day) can't be later than RESERVATION_LAST_DAY.
  * 	$num_ppl: The amount of people for which this reservation is made.
  * #return:
  * 	ESCAPE_TECHNION_NULL_PARAMETER - If a NULL parameter was given,
@@ -183,6 +223,11 @@ char* email);
  * 	ESCAPE_TECHNION_CLIENT_IN_ROOM - If the escaper already has a reservation
  * 	for a room at that time,
  * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ * An order changes only its escaper and its room, so orders (and
+ * recommendations) of different escapers to different rooms can be made by a
+ * few threads at the same time, as long as no other function changes the
+ * system meanwhile. Orders of the same escaper, or to the same room, have to
+ * be made one after the other.
  */
 EscapeTechnionResult escapeTechnionEscaperOrder(EscapeTechnion sys, char* email,
 TechnionFaculty faculty, int id, char* time, int num_ppl);
@@ -201,14 +246,38 @@ TechnionFaculty faculty, int id, char* time, int num_ppl);
  * 	the system by that email,
  * 	ESCAPE_TECHNION_NO_ROOMS_AVAILABLE - If there are no rooms in the system,
  * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ * Just like an order, a recommendation changes only its escaper and the room
+ * it's made for (see escapeTechnionRecommendedRoom).
  */
 EscapeTechnionResult escapeTechnionEscaperRecommend(EscapeTechnion sys,
 char* email, int num_ppl);
 
+/*
+ * Finds the room a recommendation for an escaper would be made for, without
+ * making it. The room depends only on the escaper and on the rooms in the
+ * system (and not on their reservations), so a thread can find it (and lock
+ * it) before the recommendation is made.
+ * 	$email: The email of the escaper.
+ * 	$num_ppl: The amount of people for which the reservation would be made.
+ * 	$faculty: Where the faculty of the room is stored.
+ * 	$id: Where the id of the room is stored.
+ * #return:
+ * 	The same errors escapeTechnionEscaperRecommend returns (before making a
+ * 	reservation), or ESCAPE_TECHNION_NULL_PARAMETER if faculty or id are NULL,
+ * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ */
+EscapeTechnionResult escapeTechnionRecommendedRoom(EscapeTechnion sys,
+char* email, int num_ppl, TechnionFaculty* faculty, int* id);
+
 /*
  * Fulfills all of today's reservations, and prints them to the system's
  * output channel. The order of printing: By hour->By faculty->By id
  * (from smallest to biggest). The system's day is then moved by one.
+ * #return:
+ * 	ESCAPE_TECHNION_NULL_PARAMETER - If a NULL parameter was given,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed (nothing is
+ * 	printed, and the day doesn't change),
+ * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
  */
 EscapeTechnionResult escapeTechnionReportDay(EscapeTechnion sys);
 
@@ -216,7 +285,40 @@ EscapeTechnionResult escapeTechnionReportDay(EscapeTechnion sys);
  * Prints the top 3 faculties in the system (the faculties that earned the most
  * money) to the system's output channel. The order of printing:
  * By money(from biggest to smallest) -> By faculty(From smallest to biggest).
+ * The earnings are read from an immutable view that's published whenever an
+ * operation that changes them is done, so the report is consistent with one
+ * point in time, and it can be printed by one thread while another thread
+ * changes the system.
  */
 EscapeTechnionResult escapeTechnionReportBest(EscapeTechnion sys);
 
+/*
+ * Writes a binary image of the system to a file: the current day, the
+ * companies and their rooms (with the money each room has earned), and the
+ * escapers with their reservations. The faculties' revenues aren't written,
+ * since they're the sums of their rooms' earnings.
+ * 	$file: A file stream, opened for binary writing. It isn't closed.
+ * #return:
+ * 	ESCAPE_TECHNION_NULL_PARAMETER - If a NULL parameter was given,
+ * 	ESCAPE_TECHNION_OUT_OF_MEMORY - If an allocation has failed,
+ * 	ESCAPE_TECHNION_CHECKPOINT_FAILED - If writing to the file has failed,
+ * 	ESCAPE_TECHNION_SUCCESS - Otherwise.
+ */
+EscapeTechnionResult escapeTechnionSave(EscapeTechnion sys, FILE* file);
+
+/*
+ * Allocates a new EscapeTechnion system from an image written by
+ * escapeTechnionSave. The entities are created straight from the image (and
+ * not copied), and the reservations are scheduled again, so the new system
+ * behaves exactly like the one that was saved. The output channel is stdout.
+ * 	$result: Holds the result of the load function. Can be sent as NULL if
+ * 	the result of this function is not needed.
+ * 	$file: A file stream, opened for binary reading. It isn't closed.
+ * #return:
+ * 	NULL if a NULL parameter was given, an allocation has failed, or the file
+ * 	isn't a valid image (ESCAPE_TECHNION_CHECKPOINT_FAILED),
+ * 	and the new system otherwise.
+ */
+EscapeTechnion escapeTechnionLoad(EscapeTechnionResult* result, FILE* file);
+
 #endif /* ESCAPETECHNION_H_ */
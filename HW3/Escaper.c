@@ -1,22 +1,37 @@
 #include "Escaper.h"
 
+/*
+ * An order of the escaper: a reservation, and the room that owns it.
+ */
+typedef struct EscaperOrder_t {
+	int time; //The absolute time of the reservation.
+	Reservation reservation; //The reservation.
+	Room room; //The reserved room.
+} EscaperOrder;
+
 /*
  * Implementation of the Escaper ADT declared in the .h file:
  * The struct's exposed name is of the pointer "Escaper".
  */
 struct Escaper_t {
-	char* email; //The escaper's email.
+	int email_id; //The id of the escaper's email (in the system's index).
 	TechnionFaculty faculty; //The escaper's Faculty.
 	int skill_level; //The escaper's skill level.
-	Set client_schedule; //A set of the escaper's scheduled hours of orders.
+	Occupancy client_schedule; //The hours of the escaper's orders, per day.
+	EscaperOrder* orders; //The escaper's orders, sorted by time.
+	int reservations_amount; //The amount of the escaper's orders.
+	int orders_capacity; //The amount of orders the array can hold.
 };
 
-//In our format, an email must contain this sign.
-#define EMAIL_SIGN '@'
-
 //Total amount of hours in one day.
 #define HOURS_IN_A_DAY 24
 
+//The initial amount of orders the array can hold.
+#define INITIAL_ORDERS 4
+
+//The array grows by this factor each time.
+#define GROWTH_FACTOR 2
+
 /*
  * A macro for checking the validity of a boolean condition.
  * 	$bool_condition - any boolean condition.
@@ -32,131 +47,97 @@ struct Escaper_t {
 #define INIT_IF_EXISTS(ptr, value) \
 	if(ptr) { (*ptr) = value; }
 
-static SetElement copyInteger(SetElement num);
-static void freeInteger(SetElement num);
-static int compareIntegers(SetElement num1, SetElement num2);
-static bool isLegalEmail(char* email);
-static bool checkParameters(char* email, TechnionFaculty faculty,
+static bool checkParameters(int email_id, TechnionFaculty faculty,
 int skill_level);
-void escaperExecuteReservations(Escaper escaper);
-
-/*
- * A static function that defines the escaper's set's copy function.
- * The copy function is required to get an element of type SetElement, and
- * return an element of the same type.
- * The copy function is defined as follows: We allocate a new integer pointer,
- * and then - the set's elements are of the type "int*", so we cast the element
- * to be its real type and dereference the pointer to get the value, and store
- * that value as the value of the the dereferenced allocated integer. We then
- * return the new integer, or NULL if the allocation has failed.
- */
-static SetElement copyInteger(SetElement num) {
-	int* copy = malloc(sizeof(int));
-	CHECK_VALID(copy, NULL)
-	*copy = *((int*)(num));
-	return copy;
-}
-
-/*
- * A static function that defines the escaper's set's free function.
- * The free function is required to get an element of type SetElement, and
- * return void. The free function is defined as follows: we simply free the
- * the non-complex int* type.
- */
-static void freeInteger(SetElement num) {
-	free(num);
-}
-
-/*
- * A static function that defines the escaper's set's compare function.
- * The compare function is required to get two elements of type SetElement, and
- * return an integer.
- * The compare function is defined as follows: the set's elements are of the
- * type "int*", so we cast the element to be its real type, and then
- * dereference to get the value that these pointers hold, and return an
- * arithmetical subtraction.
- */
-static int compareIntegers(SetElement num1, SetElement num2) {
-	return (*((int*)(num1)) - *((int*)(num2)));
-}
-
-/*
- * A static function used in order to check if the escaper's
- * email is valid by checking if it has the char '@' only one time in it
- */
-static bool isLegalEmail(char* email){
-	assert(email);
-	int i=0, count=0;
-	while(email[i])
-		if(email[i++] == EMAIL_SIGN)
-			count++;
-	return (count == 1);
-}
+static int findOrder(Escaper escaper, int time, bool* found);
+static bool reserveOrder(Escaper escaper);
 
 /*
  * A static function used in order to check the validity of the parameters
  * that were used in order to define the to-be-allocated room.
- * 	$The escaper's email: checks if the email is NULL and if
- * 	an email has the char '@' in it
+ * 	$The id of the escaper's email: a non-negative number
  * 	$The escaper's skill level: a number between 1 and 10 (included)
  * 	#return:
  * 	 false - if any of the parameters does not meet the listed requirements.
  *	 true - otherwise.
  */
-static bool checkParameters(char* email, TechnionFaculty faculty,
+static bool checkParameters(int email_id, TechnionFaculty faculty,
 int skill_level) {
 	CHECK_VALID(((faculty>=0) && (faculty<UNKNOWN)), false)
-	CHECK_VALID(email, false)
-	CHECK_VALID(isLegalEmail(email), false)
+	CHECK_VALID((email_id>=0), false)
 	CHECK_VALID(((skill_level>=1) && (skill_level<=10)), false)
 	return true;
 }
 
 /*
- * Removes all of today's reservation from this escaper's scheduled reservations
+ * A static function that finds the place of a time in the escaper's orders
+ * (binary search).
+ * 	$found: Address where we store whether the escaper has an order then.
+ * #return:
+ * 	The place of the order if it's there, and otherwise - the place where it
+ * 	should be inserted.
  */
-void escaperExecuteReservations(Escaper escaper) {
-	assert(escaper);
-	int* hours = ((int*)setGetFirst(escaper->client_schedule));
-	while((hours) && (*hours < HOURS_IN_A_DAY)) {
-		setRemove(escaper->client_schedule, hours);
-		hours = ((int*)setGetFirst(escaper->client_schedule));
+static int findOrder(Escaper escaper, int time, bool* found) {
+	assert(escaper && found);
+	int low = 0, high = escaper->reservations_amount;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(escaper->orders[middle].time < time)
+			low = middle+1;
+		else
+			high = middle;
 	}
+	*found = ((low < escaper->reservations_amount) &&
+	(escaper->orders[low].time == time));
+	return low;
+}
+
+/*
+ * A static function that makes sure there's room for one more order in the
+ * escaper's array (it's called before an order is made, so that adding the
+ * order can't fail afterwards).
+ * #return:
+ * 	false - if an allocation has failed (the array is left unchanged),
+ * 	true - otherwise.
+ */
+static bool reserveOrder(Escaper escaper) {
+	assert(escaper);
+	CHECK_VALID((escaper->reservations_amount == escaper->orders_capacity),
+	true)
+	int new_capacity = (escaper->orders_capacity == 0) ? (INITIAL_ORDERS) :
+	(escaper->orders_capacity*GROWTH_FACTOR);
+	EscaperOrder* new_orders = realloc(escaper->orders,
+	new_capacity*sizeof(*new_orders));
+	CHECK_VALID(new_orders, false)
+	escaper->orders = new_orders;
+	escaper->orders_capacity = new_capacity;
+	return true;
 }
 
-Escaper escaperCreate(EscaperResult *result, char* email,
+Escaper escaperCreate(EscaperResult *result, int email_id,
 TechnionFaculty faculty, int skill_level) {
-	if(!email) {
-		INIT_IF_EXISTS(result, ESCAPER_NULL_PARAMETER);
-		return NULL;
-	}
-	if(!checkParameters(email, faculty, skill_level)) {
+	if(!checkParameters(email_id, faculty, skill_level)) {
 		INIT_IF_EXISTS(result, ESCAPER_INVALID_PARAMETER);
 		return NULL;
 	}
 	//input is valid!
-	char* email_copy = malloc(strlen(email)+1);
-	if(!email_copy) {
-		INIT_IF_EXISTS(result, ESCAPER_OUT_OF_MEMORY);
-		return NULL;
-	}
-	strcpy(email_copy, email);
 	Escaper escaper = malloc(sizeof(*escaper));
 	if(!escaper) {
-		free(email_copy);
 		INIT_IF_EXISTS(result, ESCAPER_OUT_OF_MEMORY);
 		return NULL;
 	}
-	escaper->client_schedule = setCreate(copyInteger, freeInteger,
-	compareIntegers);
+	escaper->client_schedule = occupancyCreate();
 	if(!(escaper->client_schedule)) {
-		free(email_copy);
 		free(escaper);
 		INIT_IF_EXISTS(result, ESCAPER_OUT_OF_MEMORY);
 		return NULL;;
 	}
+	//The orders array is allocated when the first order is made.
+	escaper->orders = NULL;
+	escaper->reservations_amount = 0;
+	escaper->orders_capacity = 0;
 	//Initialize the struct's fields:
-	escaper->email = email_copy;
+	escaper->email_id = email_id;
 	escaper->faculty = faculty;
 	escaper->skill_level = skill_level;
 	INIT_IF_EXISTS(result, ESCAPER_SUCCESS);
@@ -165,25 +146,24 @@ TechnionFaculty faculty, int skill_level) {
 
 EscaperResult escaperDestroy(Escaper escaper){
 	CHECK_VALID(escaper,ESCAPER_NULL_PARAMETER)
-	setDestroy(escaper->client_schedule);
-	free(escaper->email);
+	occupancyDestroy(escaper->client_schedule);
+	free(escaper->orders);
 	free(escaper);
 	return ESCAPER_SUCCESS;
 }
 
 Escaper escaperCopy(Escaper escaper){
 	CHECK_VALID(escaper, NULL)
-	Escaper escaper_copy = escaperCreate(NULL, escaper->email, escaper->faculty,
-	escaper->skill_level);
-	CHECK_VALID(escaper_copy, NULL)
-	setDestroy(escaper_copy->client_schedule);
-	escaper_copy->client_schedule = setCopy(escaper->client_schedule);
+	Escaper escaper_copy = escaperCreate(NULL, escaper->email_id,
+	escaper->faculty, escaper->skill_level);
+	//The orders point to the original's rooms, so they aren't copied.
 	return escaper_copy;
 }
-EscaperResult escaperGetEmail(Escaper escaper, char** email){
+
+EscaperResult escaperGetEmailId(Escaper escaper, int* email_id){
 	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
-	CHECK_VALID(email, ESCAPER_NULL_PARAMETER)
-	*email = escaper->email;
+	CHECK_VALID(email_id, ESCAPER_NULL_PARAMETER)
+	*email_id = escaper->email_id;
 	return ESCAPER_SUCCESS;
 }
 
@@ -204,62 +184,104 @@ EscaperResult escaperGetSkillLevel(Escaper escaper, int* skill_level){
 EscaperResult escaperReservationsAmount(Escaper escaper, int* amount) {
 	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
 	CHECK_VALID(amount, ESCAPER_NULL_PARAMETER)
-	*amount = setGetSize(escaper->client_schedule);
+	*amount = escaper->reservations_amount;
 	return ESCAPER_SUCCESS;
 }
 
-EscaperResult escaperMakeReservation(Escaper escaper, Room room,
-TechnionFaculty faculty, int num_of_people, char* date) {
+EscaperResult escaperGetSchedule(Escaper escaper, Occupancy* schedule) {
+	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
+	CHECK_VALID(schedule, ESCAPER_NULL_PARAMETER)
+	*schedule = escaper->client_schedule;
+	return ESCAPER_SUCCESS;
+}
+
+EscaperResult escaperMakeReservation(Escaper escaper, Pool pool, Room room,
+TechnionFaculty faculty, int num_of_people, int day, int hour,
+Reservation* reservation) {
 	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
 	CHECK_VALID(room, ESCAPER_NULL_PARAMETER)
-	CHECK_VALID(date, ESCAPER_NULL_PARAMETER)
 	int id = 0, price = 0, open = 0, close = 0;
 	roomGetId(room, &id);
 	roomGetPrice(room, &price);
 	roomGetOpenTime(room, &open);
 	roomGetCloseTime(room, &close);
-	Reservation res = reservationCreate(NULL, escaper->email, id, faculty,
-	price, open, close, num_of_people, date, ((escaper->faculty) == faculty));
-	CHECK_VALID(res, ESCAPER_OUT_OF_MEMORY)
-	int hour = reservationHoursLeft(res);
-	SetResult result1 = setAdd(escaper->client_schedule, &hour);
-	if(result1 != SET_SUCCESS) {
-		//There are only two options for failure here. We return the correct one
+	ReservationResult create_result = RESERVATION_SUCCESS;
+	Reservation res = reservationCreate(&create_result, pool, escaper->email_id,
+	id, faculty, price, open, close, num_of_people, day, hour,
+	((escaper->faculty) == faculty));
+	if(!res)
+		//The parameters might not fit the room (like an hour it's closed at).
+		return (create_result == RESERVATION_OUT_OF_MEMORY) ?
+		(ESCAPER_OUT_OF_MEMORY) : (ESCAPER_INVALID_PARAMETER);
+	EscaperResult result1 = escaperAddReservation(escaper, room, res);
+	if(result1 != ESCAPER_SUCCESS) {
 		reservationDestroy(res);
-		return (result1 == SET_OUT_OF_MEMORY) ?
-		(ESCAPER_OUT_OF_MEMORY) : (ESCAPER_IN_ROOM);
+		return result1;
 	}
 	RoomResult result2 = roomNewReservation(room, res);
 	if(result2 != ROOM_SUCCESS) {
 		//There are only two options for failure here. We return the correct one
+		escaperRemoveReservation(escaper, reservationGetTime(res));
 		reservationDestroy(res);
-		setRemove(escaper->client_schedule, &hour);
 		return (result2 == ROOM_OUT_OF_MEMORY) ?
 		(ESCAPER_OUT_OF_MEMORY) : (ESCAPER_RESERVED_ROOM);
 	}
-	reservationDestroy(res);
+	//The room took ownership of the reservation.
+	INIT_IF_EXISTS(reservation, res);
 	return ESCAPER_SUCCESS;
 }
 
-EscaperResult escaperNextDay(Escaper escaper) {
-	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
-	escaperExecuteReservations(escaper);
-	SET_FOREACH(int*, time, escaper->client_schedule) {
-		assert(time);
-		(*time) -= HOURS_IN_A_DAY; //Time of the reservation decreased by 24.
-	}
-	return ROOM_SUCCESS;
+EscaperResult escaperAddReservation(Escaper escaper, Room room,
+Reservation reservation) {
+	CHECK_VALID(escaper && room && reservation, ESCAPER_NULL_PARAMETER)
+	int day = reservationGetDay(reservation),
+	hour = reservationGetHour(reservation);
+	//The array is grown first, so nothing has to be undone once the hour is
+	//reserved.
+	CHECK_VALID(reserveOrder(escaper), ESCAPER_OUT_OF_MEMORY)
+	OccupancyResult result = occupancyReserve(escaper->client_schedule, day,
+	hour);
+	if(result != OCCUPANCY_SUCCESS)
+		//There are only two options for failure here. We return the correct one
+		return (result == OCCUPANCY_OUT_OF_MEMORY) ?
+		(ESCAPER_OUT_OF_MEMORY) : (ESCAPER_IN_ROOM);
+	bool found = false;
+	int time = reservationGetTime(reservation),
+	place = findOrder(escaper, time, &found);
+	memmove(&(escaper->orders[place+1]), &(escaper->orders[place]),
+	(escaper->reservations_amount - place)*sizeof(*(escaper->orders)));
+	escaper->orders[place].time = time;
+	escaper->orders[place].reservation = reservation;
+	escaper->orders[place].room = room;
+	(escaper->reservations_amount)++;
+	//The reservation belongs to the escaper that holds it.
+	reservationSetEscaperId(reservation, escaper->email_id);
+	return ESCAPER_SUCCESS;
 }
 
-bool escaperIsBusy(Escaper escaper, int hours) {
-	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
-	return setIsIn(escaper->client_schedule, &hours);
+Reservation escaperGetReservation(Escaper escaper, int index, Room* room) {
+	CHECK_VALID(escaper, NULL)
+	CHECK_VALID(((index >= 0) && (index < escaper->reservations_amount)), NULL)
+	INIT_IF_EXISTS(room, escaper->orders[index].room);
+	return escaper->orders[index].reservation;
+}
+
+bool escaperIsBusy(Escaper escaper, int time) {
+	CHECK_VALID(escaper, false)
+	CHECK_VALID((time >= 0), false)
+	return occupancyIsReserved(escaper->client_schedule,
+	time / HOURS_IN_A_DAY, time % HOURS_IN_A_DAY);
 }
 
-//We ended up not using this function. Oh well, at least it looks good.
-EscaperResult escaperRemoveReservation(Escaper escaper, int hours) {
+EscaperResult escaperRemoveReservation(Escaper escaper, int time) {
 	CHECK_VALID(escaper, ESCAPER_NULL_PARAMETER)
-	if(setRemove(escaper->client_schedule, &hours) != SET_SUCCESS)
-		return ESCAPER_INVALID_PARAMETER;
+	bool found = false;
+	int place = findOrder(escaper, time, &found);
+	CHECK_VALID(found, ESCAPER_INVALID_PARAMETER)
+	occupancyRelease(escaper->client_schedule, time / HOURS_IN_A_DAY,
+	time % HOURS_IN_A_DAY);
+	memmove(&(escaper->orders[place]), &(escaper->orders[place+1]),
+	(escaper->reservations_amount - place - 1)*sizeof(*(escaper->orders)));
+	(escaper->reservations_amount)--;
 	return ESCAPER_SUCCESS;
 }
@@ -5,9 +5,9 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <stdbool.h>
-#include "set.h"
 #include "Reservation.h"
 #include "Room.h"
+#include "Occupancy.h"
 #include "mtm_ex3.h"
 
 typedef struct Escaper_t *Escaper; //Name of the ADT.
@@ -30,14 +30,15 @@ typedef enum {
  * The required fields are:
  * 	$result: Holds the result of the create function. Can be sent as NULL if
  *  the result of this function is not needed.
- * 	$email: The customer's email string. Must contain '@' exactly once.
+ * 	$email_id: The id of the customer's email, in the system's email index.
+ * 	Must be non-negative.
  * 	$faculty: The faculty that the escaper belongs to.
  * 	$skill_level: The escaper's skill level. Must be between 1 and 10.
  * #return:
  * 	NULL - If one of the parameters is invalid or an allocation fails,
  * 	and a new escaper otherwise. The new escaper has no reservations.
  */
-Escaper escaperCreate(EscaperResult *result, char* email,
+Escaper escaperCreate(EscaperResult *result, int email_id,
 TechnionFaculty faculty, int skill_level);
 
 /*
@@ -51,7 +52,10 @@ EscaperResult escaperDestroy(Escaper escaper);
 
 /*
  * Creates a copy of the target escaper.
- * The new copy will contain all the values of the source escaper's fields.
+ * The new copy will contain all the values of the source escaper's fields,
+ * but none of its reservations: they belong to the rooms of the source, so the
+ * copy's reservations are added with escaperAddReservation once its rooms are
+ * copied as well.
  * #return:
  * 	NULL if a NULL pointer was sent or a memory allocation failed,
  * 	and a new copy of the escaper otherwise.
@@ -59,13 +63,14 @@ EscaperResult escaperDestroy(Escaper escaper);
 Escaper escaperCopy(Escaper escaper);
 
 /*
- * Returns the escaper's email (in a parameter address).
- * 	$email: Address of a string that will store the email.
+ * Returns the id of the escaper's email (in a parameter address). The email
+ * is found by the id in the system's email index.
+ * 	$email_id: Address of an integer that will store the id.
  * #return:
  * 	ESCAPER_NULL_PARAMETER - if a NULL pointer was sent,
  * 	ESCAPER_SUCCESS - otherwise.
  */
-EscaperResult escaperGetEmail(Escaper escaper, char** email);
+EscaperResult escaperGetEmailId(Escaper escaper, int* email_id);
 
 /*
  * Returns the escaper's faculty (in a parameter address).
@@ -95,53 +100,97 @@ EscaperResult escaperGetSkillLevel(Escaper escaper, int* skill_level);
  */
 EscaperResult escaperReservationsAmount(Escaper escaper, int* amount);
 
+/*
+ * Returns the escaper's schedule (in a parameter address): the occupancy map
+ * of the hours the escaper has ordered. The schedule still belongs to the
+ * escaper, so it must not be changed or deallocated.
+ * 	$schedule: Address where the schedule will be stored.
+ * #return:
+ * 	ESCAPER_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	ESCAPER_SUCCESS - Otherwise.
+ */
+EscaperResult escaperGetSchedule(Escaper escaper, Occupancy* schedule);
+
 /*
  * The escaper schedules a new reservation to a room.
  * The reservation is taken into account by priority in the following way:
  * The escaper potentially has more urgent reservations
- * (reservations that should be implemented first = less days left / smaller
- * hour value), so the new reservation for the escaper will be added before or
- * after certain reservations, according to whichever comes first.
+ * (reservations that should be implemented first = earlier absolute time), so
+ * the new reservation for the escaper will be added before or after certain
+ * reservations, according to whichever comes first.
+ * 	$pool: The pool the reservation is taken from. Can be sent as NULL to
+ * 	allocate the reservation by itself.
  * 	$room: The room to which the escaper wants to order a reservation for.
  * 	$faculty: The faculty of the company that owns the desired room.
  * 	$num_of_people: The amount of people for this reservation.
- * 	$date: The scheduled time for the reservation. The time is a string of the
- * 	format: "dd-hh", where the first two digits represent how many days from now
- * 	the reservation is for, and the the last two digits represent the hour of
- * 	the day for the reservation. Days must be non-negative, hour is between 0
- * 	and 23, but has to be during the time when the escape room is open: more or
- * 	equal to the room's open time, and less than the room's close time.
+ * 	$day: The day of the reservation, counted from the system's first day.
+ * 	Must be non-negative.
+ * 	$hour: The hour of the reservation. Has to be during the time when the
+ * 	escape room is open: more or equal to the room's open time, and less than
+ * 	the room's close time.
+ * 	$reservation: Address where the new reservation (that's now owned by the
+ * 	room) will be stored. Can be sent as NULL if it's not needed.
  * #return:
  * 	ESCAPER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ESCAPER_INVALID_PARAMETER - If the reservation's parameters are illegal
+ * 	(for example, the room is closed at that hour),
  * 	ESCAPER_IN_ROOM - If the escaper has already ordered a reservation to the
  * 	same time.
  * 	ESCAPER_OUT_OF_MEMORY - If an allocation has failed.
  * 	ESCAPER_RESERVED_ROOM - If the desired room is already reserved at that time
  * 	ESCAPER_SUCCESS - Otherwise.
  */
-EscaperResult escaperMakeReservation(Escaper escaper, Room room,
-TechnionFaculty faculty, int num_of_people, char* date);
+EscaperResult escaperMakeReservation(Escaper escaper, Pool pool, Room room,
+TechnionFaculty faculty, int num_of_people, int day, int hour,
+Reservation* reservation);
 
 /*
- * Decreases a full day's worth of hours (24) from the scheduled time of all the
- * customer's reservations. Reservations for today will be fulfilled.
+ * Adds an existing reservation to the escaper's orders. The reservation stays
+ * owned by its room: the escaper only keeps a handle to it (and to the room),
+ * so the escaper's reservations are reached without going over all the rooms.
+ * 	$room: The room that owns the reservation.
+ * 	$reservation: The reservation, which was made by this escaper.
  * #return:
- *  ESCAPER_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	ESCAPER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ESCAPER_IN_ROOM - If the escaper already has a reservation at that time,
+ * 	ESCAPER_OUT_OF_MEMORY - If an allocation has failed,
  * 	ESCAPER_SUCCESS - Otherwise.
  */
-EscaperResult escaperNextDay(Escaper escaper);
+EscaperResult escaperAddReservation(Escaper escaper, Room room,
+Reservation reservation);
 
-//DOCUMENT THIS!!!
-bool escaperIsBusy(Escaper escaper, int hours);
+/*
+ * Returns one of the escaper's reservations, by its place in the escaper's
+ * orders (which are sorted by time).
+ * 	$index: The place of the reservation. Must be between 0 and the amount of
+ * 	the escaper's reservations (not included).
+ * 	$room: Address where the room that owns the reservation will be stored. Can
+ * 	be sent as NULL if it's not needed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent or the index is out of range,
+ * 	and the reservation otherwise.
+ */
+Reservation escaperGetReservation(Escaper escaper, int index, Room* room);
+
+/*
+ * Checks if the escaper has a reservation at a certain time.
+ * 	$time: The absolute time (hours from the start of the system's first day).
+ * #return:
+ * 	false - If a NULL pointer was sent or the escaper is free at that time,
+ * 	true - Otherwise.
+ */
+bool escaperIsBusy(Escaper escaper, int time);
 
 /*
- * Removes a scheduled reservation for this escaper.
- *	$hours: the scheduled hour for the reservation we are trying to remove.
+ * Removes a scheduled reservation for this escaper. Used once the reservation
+ * was fulfilled. The reservation itself is owned by its room, so it's not
+ * affected.
+ *	$time: the absolute time of the reservation we are trying to remove.
  * #return:
  *	ESCAPER_NULL_PARAMETER - If a NULL pointer was sent.
  *	ESCAPER_INVALID_PARAMETER - If there is no reservation for the desired hour,
  *	ESCAPER_SUCCESS - Otherwise.
  */
-EscaperResult escaperRemoveReservation(Escaper escaper, int hours);
+EscaperResult escaperRemoveReservation(Escaper escaper, int time);
 
 #endif /* ESCAPER_H_ */
@@ -0,0 +1,119 @@
+#include <limits.h>
+#include <string.h>
+#include "Field.h"
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for checking if a character is a decimal digit.
+ */
+#define IS_DIGIT(character) (((character) >= '0') && ((character) <= '9'))
+
+static char* readDigits(char* field, char* end, int max_digits, int* value);
+
+/*
+ * A static function that reads the digits at the start of a slice, as a
+ * non-negative number.
+ * 	$end: The address right after the slice's last character.
+ * 	$max_digits: The most digits to read (0 to read all of them).
+ * 	$value: Address where the number will be stored.
+ * #return:
+ * 	NULL if there are no digits at the start of the slice, or the number
+ * 	doesn't fit in an int,
+ * 	and the address of the first character after the digits otherwise.
+ */
+static char* readDigits(char* field, char* end, int max_digits, int* value) {
+	assert(field && end && value);
+	int number = 0, digits = 0;
+	while((field < end) && IS_DIGIT(*field) &&
+	((max_digits == 0) || (digits < max_digits))) {
+		int digit = (*field) - '0';
+		CHECK_VALID((number <= (INT_MAX - digit) / 10), NULL)
+		number = number*10 + digit;
+		digits++;
+		field++;
+	}
+	CHECK_VALID((digits > 0), NULL)
+	*value = number;
+	return field;
+}
+
+bool fieldReadInteger(char* field, int* value) {
+	CHECK_VALID(field, false)
+	return fieldReadIntegerSlice(field, strlen(field), value);
+}
+
+bool fieldReadIntegerSlice(char* field, int length, int* value) {
+	CHECK_VALID((field && value && (length >= 0)), false)
+	char* end = field + length;
+	bool negative = ((field < end) && (*field == '-'));
+	if((field < end) && ((*field == '-') || (*field == '+')))
+		field++;
+	int number = 0;
+	field = readDigits(field, end, 0, &number);
+	CHECK_VALID((field == end), false)
+	*value = (negative) ? (-number) : (number);
+	return true;
+}
+
+bool fieldReadTime(char* field, int* day, int* hour) {
+	CHECK_VALID(field, false)
+	return fieldReadTimeSlice(field, strlen(field), day, hour);
+}
+
+bool fieldReadTimeSlice(char* field, int length, int* day, int* hour) {
+	CHECK_VALID((field && day && hour && (length >= 0)), false)
+	char* end = field + length;
+	int day_value = 0, hour_value = 0;
+	field = readDigits(field, end, 0, &day_value);
+	CHECK_VALID((field && (field < end) && (*field == FIELD_SEPARATOR)), false)
+	field = readDigits(field+1, end, 0, &hour_value);
+	CHECK_VALID((field == end), false)
+	*day = day_value;
+	*hour = hour_value;
+	return true;
+}
+
+bool fieldReadHours(char* field, int* open, int* close) {
+	CHECK_VALID(field, false)
+	return fieldReadHoursSlice(field, strlen(field), open, close);
+}
+
+bool fieldReadHoursSlice(char* field, int length, int* open, int* close) {
+	CHECK_VALID((field && open && close && (length >= 0)), false)
+	char* end = field + length;
+	char* start = field;
+	int open_value = 0, close_value = 0;
+	field = readDigits(field, end, FIELD_HOUR_DIGITS, &open_value);
+	CHECK_VALID((field && (field - start == FIELD_HOUR_DIGITS) &&
+	(field < end) && (*field == FIELD_SEPARATOR)), false)
+	start = field+1;
+	field = readDigits(start, end, FIELD_HOUR_DIGITS, &close_value);
+	CHECK_VALID((field && (field - start == FIELD_HOUR_DIGITS) &&
+	(field == end)), false)
+	*open = open_value;
+	*close = close_value;
+	return true;
+}
+
+bool fieldIsEmail(char* field) {
+	CHECK_VALID(field, false)
+	return fieldIsEmailSlice(field, strlen(field));
+}
+
+bool fieldIsEmailSlice(char* field, int length) {
+	CHECK_VALID((field && (length >= 0)), false)
+	char* end = field + length;
+	int count = 0;
+	while(field < end)
+		if(*(field++) == FIELD_EMAIL_SIGN)
+			count++;
+	return (count == 1);
+}
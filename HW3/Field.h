@@ -0,0 +1,112 @@
+#ifndef FIELD_H_
+#define FIELD_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/*
+ * Readers for the fields of the commands: times, working hours, emails and
+ * integers. Every reader checks a field and converts it in a single pass over
+ * its characters, straight from the command's words (nothing is copied or
+ * allocated), so a field is read once, where it enters the system, and the
+ * ADTs get the values it holds.
+ * Every reader has a version for a whole string, and a version for a slice of
+ * a longer string (a word that's still inside its command line), which is
+ * given by its first character and its length and isn't terminated.
+ */
+
+//In our format, hours are represented as two digits.
+#define FIELD_HOUR_DIGITS 2
+
+//In our format, days and hours (or two hours) are separated with a dash sign.
+#define FIELD_SEPARATOR '-'
+
+//A valid email must contain exactly one of this sign.
+#define FIELD_EMAIL_SIGN '@'
+
+/*
+ * A slice of a string: its first character and its length. The slice isn't
+ * terminated, and the string it's a part of isn't changed.
+ */
+typedef struct FieldSlice_t {
+	char* start; //The slice's first character.
+	int length; //The amount of characters in the slice.
+} FieldSlice;
+
+/*
+ * Reads a whole field as a decimal integer, with an optional sign.
+ * 	$field: The field's string.
+ * 	$value: Address where the integer will be stored. It isn't changed if the
+ * 	field isn't valid.
+ * #return:
+ * 	false if a NULL pointer was sent, the field has a character that isn't a
+ * 	digit (other than the sign), has no digits, or doesn't fit in an int,
+ * 	and true otherwise.
+ */
+bool fieldReadInteger(char* field, int* value);
+
+/*
+ * Reads a slice as a decimal integer, just like fieldReadInteger.
+ * 	$field: The slice's first character.
+ * 	$length: The slice's length.
+ */
+bool fieldReadIntegerSlice(char* field, int length, int* value);
+
+/*
+ * Reads a time of the format "dd-hh": a day and an hour, each made of one or
+ * more digits, separated by a dash.
+ * 	$field: The field's string.
+ * 	$day: Address where the day will be stored.
+ * 	$hour: Address where the hour will be stored.
+ * The values aren't checked against any range, only their format is.
+ * #return:
+ * 	false if a NULL pointer was sent or the field isn't of that format (or one
+ * 	of its numbers doesn't fit in an int),
+ * 	and true otherwise.
+ */
+bool fieldReadTime(char* field, int* day, int* hour);
+
+/*
+ * Reads a slice as a time, just like fieldReadTime.
+ * 	$field: The slice's first character.
+ * 	$length: The slice's length.
+ */
+bool fieldReadTimeSlice(char* field, int length, int* day, int* hour);
+
+/*
+ * Reads working hours of the format "xx-yy": two hours of exactly two digits
+ * each, separated by a dash.
+ * 	$field: The field's string.
+ * 	$open: Address where the first hour will be stored.
+ * 	$close: Address where the second hour will be stored.
+ * The hours aren't checked against any range, only their format is.
+ * #return:
+ * 	false if a NULL pointer was sent or the field isn't of that format,
+ * 	and true otherwise.
+ */
+bool fieldReadHours(char* field, int* open, int* close);
+
+/*
+ * Reads a slice as working hours, just like fieldReadHours.
+ * 	$field: The slice's first character.
+ * 	$length: The slice's length.
+ */
+bool fieldReadHoursSlice(char* field, int length, int* open, int* close);
+
+/*
+ * Checks if a field is a legal email: an email that contains exactly one '@'.
+ * #return:
+ * 	false if a NULL pointer was sent or the email isn't legal,
+ * 	and true otherwise.
+ */
+bool fieldIsEmail(char* field);
+
+/*
+ * Checks if a slice is a legal email, just like fieldIsEmail.
+ * 	$field: The slice's first character.
+ * 	$length: The slice's length.
+ */
+bool fieldIsEmailSlice(char* field, int length);
+
+#endif /* FIELD_H_ */
@@ -0,0 +1,285 @@
+#include "HashTable.h"
+
+/*
+ * A slot of the table: whether it holds an entry, and the hash value of the
+ * entry's key. The entries themselves are kept in an array of their own, in
+ * the same order as the slots.
+ */
+typedef struct HashSlot_t {
+	unsigned int hash; //The hash value of the entry's key.
+	bool used; //Whether the slot holds an entry.
+} HashSlot;
+
+/*
+ * Implementation of the HashTable ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "HashTable".
+ */
+struct HashTable_t {
+	HashSlot* slots; //The table's slots (NULL before the first insertion).
+	char* entries; //The entries of the slots, entry_size bytes each.
+	size_t entry_size; //The size of every entry.
+	int initial_capacity; //The amount of slots of the first allocation.
+	int capacity; //The amount of slots in the table.
+	int size; //The amount of entries in the table.
+	HashTableMatchFunction match; //Checks whether an entry has a key.
+};
+
+//The table grows once it's more than (1 / LOAD_FACTOR_DIVISOR) full.
+#define LOAD_FACTOR_DIVISOR 2
+
+//The table grows by this factor each time.
+#define GROWTH_FACTOR 2
+
+//The multiplier of the integer hash (2^32 divided by the golden ratio).
+#define HASH_MULTIPLIER 2654435761u
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for assigning a value to a pointer iff it's not NULL.
+ */
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+/*
+ * A macro for the home slot of a hash value in the table.
+ */
+#define HOME_SLOT(table, hash) \
+	((int)((hash) & (unsigned int)((table)->capacity - 1)))
+
+/*
+ * A macro for moving to the next slot in the table (cyclically).
+ */
+#define NEXT_SLOT(table, slot) (((slot) + 1) & ((table)->capacity - 1))
+
+/*
+ * A macro for the entry of a slot.
+ */
+#define ENTRY(table, slot) \
+	((void*)((table)->entries + (size_t)(slot) * (table)->entry_size))
+
+static bool isPowerOfTwo(int number);
+static bool allocateSlots(HashTable table, int capacity);
+static int findSlot(HashTable table, unsigned int hash, void* key);
+static bool growTable(HashTable table);
+static void removeSlot(HashTable table, int slot);
+
+/*
+ * A static function that checks if a number is a positive power of 2.
+ */
+static bool isPowerOfTwo(int number) {
+	return ((number > 0) && ((number & (number - 1)) == 0));
+}
+
+/*
+ * A static function that gives a table new empty slots (and entries). The old
+ * ones aren't freed.
+ * #return:
+ * 	false - if an allocation has failed (the table is left unchanged),
+ * 	true - otherwise.
+ */
+static bool allocateSlots(HashTable table, int capacity) {
+	assert(table && isPowerOfTwo(capacity));
+	HashSlot* slots = calloc(capacity, sizeof(*slots));
+	char* entries = malloc(capacity*table->entry_size);
+	if(!slots || !entries) {
+		free(slots);
+		free(entries);
+		return false;
+	}
+	table->slots = slots;
+	table->entries = entries;
+	table->capacity = capacity;
+	return true;
+}
+
+/*
+ * A static function that finds the slot of a key in the table (which must
+ * have slots).
+ * #return:
+ * 	The slot that holds the key's entry if it's in the table, and otherwise -
+ * 	the empty slot where it should be inserted.
+ */
+static int findSlot(HashTable table, unsigned int hash, void* key) {
+	assert(table && (table->capacity > 0));
+	int slot = HOME_SLOT(table, hash);
+	while(table->slots[slot].used && !((table->slots[slot].hash == hash) &&
+	table->match(ENTRY(table, slot), key)))
+		slot = NEXT_SLOT(table, slot);
+	return slot;
+}
+
+/*
+ * A static function that moves all the entries of the table into a new table
+ * with more slots (a table with no slots gets its initial slots).
+ * #return:
+ * 	false - if an allocation has failed (the table is left unchanged),
+ * 	true - otherwise.
+ */
+static bool growTable(HashTable table) {
+	assert(table);
+	HashSlot* old_slots = table->slots;
+	char* old_entries = table->entries;
+	int old_capacity = table->capacity;
+	CHECK_VALID(allocateSlots(table, (old_capacity == 0) ?
+	(table->initial_capacity) : (old_capacity*GROWTH_FACTOR)), false)
+	for(int i=0; i<old_capacity; i++) {
+		if(!old_slots[i].used)
+			continue;
+		//The keys are all different, so an entry goes to the first empty slot
+		//from its home slot.
+		int slot = HOME_SLOT(table, old_slots[i].hash);
+		while(table->slots[slot].used)
+			slot = NEXT_SLOT(table, slot);
+		table->slots[slot] = old_slots[i];
+		memcpy(ENTRY(table, slot), old_entries + (size_t)i*table->entry_size,
+		table->entry_size);
+	}
+	free(old_slots);
+	free(old_entries);
+	return true;
+}
+
+/*
+ * A static function that empties a slot in the table. The entries that come
+ * after it (in the same probing sequence) are shifted back, so that no entry
+ * ends up unreachable from its home slot.
+ */
+static void removeSlot(HashTable table, int slot) {
+	assert(table && table->slots[slot].used);
+	int hole = slot, next = NEXT_SLOT(table, slot);
+	while(table->slots[next].used) {
+		int home = HOME_SLOT(table, table->slots[next].hash);
+		//The entry can fill the hole iff the hole is between its home slot and
+		//its current slot (cyclically).
+		bool can_move = (hole <= next) ? ((home <= hole) || (home > next)) :
+		((home <= hole) && (home > next));
+		if(can_move) {
+			table->slots[hole] = table->slots[next];
+			memcpy(ENTRY(table, hole), ENTRY(table, next), table->entry_size);
+			hole = next;
+		}
+		next = NEXT_SLOT(table, next);
+	}
+	table->slots[hole].used = false;
+}
+
+HashTable hashTableCreate(HashTableResult* result, size_t entry_size,
+int initial_capacity, HashTableMatchFunction match) {
+	if(!match) {
+		INIT_IF_EXISTS(result, HASH_TABLE_NULL_PARAMETER);
+		return NULL;
+	}
+	if((entry_size == 0) || !isPowerOfTwo(initial_capacity)) {
+		INIT_IF_EXISTS(result, HASH_TABLE_INVALID_PARAMETER);
+		return NULL;
+	}
+	HashTable table = malloc(sizeof(*table));
+	if(!table) {
+		INIT_IF_EXISTS(result, HASH_TABLE_OUT_OF_MEMORY);
+		return NULL;
+	}
+	//The slots are allocated on the first insertion.
+	table->slots = NULL;
+	table->entries = NULL;
+	table->entry_size = entry_size;
+	table->initial_capacity = initial_capacity;
+	table->capacity = 0;
+	table->size = 0;
+	table->match = match;
+	INIT_IF_EXISTS(result, HASH_TABLE_SUCCESS);
+	return table;
+}
+
+HashTableResult hashTableDestroy(HashTable table) {
+	CHECK_VALID(table, HASH_TABLE_NULL_PARAMETER)
+	free(table->slots);
+	free(table->entries);
+	free(table);
+	return HASH_TABLE_SUCCESS;
+}
+
+HashTable hashTableCopy(HashTable table) {
+	CHECK_VALID(table, NULL)
+	HashTable table_copy = hashTableCreate(NULL, table->entry_size,
+	table->initial_capacity, table->match);
+	CHECK_VALID(table_copy, NULL)
+	if(table->capacity == 0)
+		return table_copy;
+	if(!allocateSlots(table_copy, table->capacity)) {
+		hashTableDestroy(table_copy);
+		return NULL;
+	}
+	memcpy(table_copy->slots, table->slots,
+	table->capacity*sizeof(*(table->slots)));
+	memcpy(table_copy->entries, table->entries,
+	table->capacity*table->entry_size);
+	table_copy->size = table->size;
+	return table_copy;
+}
+
+void* hashTableInsert(HashTableResult* result, HashTable table,
+unsigned int hash, void* key) {
+	if(!table) {
+		INIT_IF_EXISTS(result, HASH_TABLE_NULL_PARAMETER);
+		return NULL;
+	}
+	if((table->capacity > 0) &&
+	(table->slots[findSlot(table, hash, key)].used)) {
+		INIT_IF_EXISTS(result, HASH_TABLE_KEY_EXISTS);
+		return NULL;
+	}
+	//The table is getting crowded. We grow it before inserting.
+	if(((table->size+1)*LOAD_FACTOR_DIVISOR > table->capacity) &&
+	!growTable(table)) {
+		INIT_IF_EXISTS(result, HASH_TABLE_OUT_OF_MEMORY);
+		return NULL;
+	}
+	int slot = findSlot(table, hash, key);
+	table->slots[slot].hash = hash;
+	table->slots[slot].used = true;
+	memset(ENTRY(table, slot), 0, table->entry_size);
+	(table->size)++;
+	INIT_IF_EXISTS(result, HASH_TABLE_SUCCESS);
+	return ENTRY(table, slot);
+}
+
+void* hashTableFind(HashTable table, unsigned int hash, void* key) {
+	CHECK_VALID(table, NULL)
+	CHECK_VALID((table->capacity > 0), NULL)
+	int slot = findSlot(table, hash, key);
+	return (table->slots[slot].used) ? (ENTRY(table, slot)) : (NULL);
+}
+
+HashTableResult hashTableRemove(HashTable table, void* entry) {
+	CHECK_VALID(table, HASH_TABLE_NULL_PARAMETER)
+	CHECK_VALID(entry, HASH_TABLE_NULL_PARAMETER)
+	char* position = entry;
+	CHECK_VALID(((table->capacity > 0) && (position >= table->entries) &&
+	(position < table->entries + (size_t)table->capacity*table->entry_size)),
+	HASH_TABLE_ENTRY_DOES_NOT_EXIST)
+	size_t offset = (size_t)(position - table->entries);
+	CHECK_VALID((offset % table->entry_size == 0),
+	HASH_TABLE_ENTRY_DOES_NOT_EXIST)
+	int slot = (int)(offset / table->entry_size);
+	CHECK_VALID(table->slots[slot].used, HASH_TABLE_ENTRY_DOES_NOT_EXIST)
+	removeSlot(table, slot);
+	(table->size)--;
+	return HASH_TABLE_SUCCESS;
+}
+
+int hashTableGetSize(HashTable table) {
+	CHECK_VALID(table, -1)
+	return table->size;
+}
+
+unsigned int hashTableHashInt(int key) {
+	return (unsigned int)key * HASH_MULTIPLIER;
+}
@@ -0,0 +1,125 @@
+#ifndef HASHTABLE_H_
+#define HASHTABLE_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+
+typedef struct HashTable_t *HashTable; //Name of the ADT.
+
+typedef enum {
+	//The hash table's errors:
+	HASH_TABLE_SUCCESS,
+	HASH_TABLE_NULL_PARAMETER,
+	HASH_TABLE_INVALID_PARAMETER,
+	HASH_TABLE_OUT_OF_MEMORY,
+	HASH_TABLE_KEY_EXISTS,
+	HASH_TABLE_ENTRY_DOES_NOT_EXIST,
+} HashTableResult;
+
+/*
+ * Type of function used by the table to check whether an entry has a key.
+ * 	$entry: An entry of the table.
+ * 	$key: The key that was sent to the table (its type is up to the user).
+ * The function is only called for entries with the same hash value as the key.
+ * #return:
+ * 	true if the entry's key is the same as the key, and false otherwise.
+ */
+typedef bool (*HashTableMatchFunction)(void* entry, void* key);
+
+/*
+ * Allocates a new, empty hash table.
+ * The table is an open addressing hash table (with linear probing), whose
+ * entries are all of one size and are kept in its own slots. The user
+ * calculates the hash value of a key, and the table keeps it with the entry,
+ * so it's never calculated again (the table is rebuilt and its entries are
+ * shifted by their kept hash values). The table's capacity is always a power
+ * of 2, and it grows once it's half full. A removed entry's slot is filled by
+ * the entries after it, so the table has no tombstones.
+ * The table doesn't know what its entries hold: they're copied as they are,
+ * and nothing they point to is freed by the table.
+ * 	$result: Holds the result of the create function. Can be sent as NULL if
+ * 	the result of this function is not needed.
+ * 	$entry_size: The size of every entry. Must be positive.
+ * 	$initial_capacity: The amount of slots the table gets on its first
+ * 	insertion (a table takes no slots before it). Must be a positive power
+ * 	of 2.
+ * 	$match: The function that checks whether an entry has a key.
+ * #return:
+ * 	NULL if a NULL pointer was sent, a parameter is invalid or an allocation
+ * 	has failed,
+ * 	and a new hash table otherwise.
+ */
+HashTable hashTableCreate(HashTableResult* result, size_t entry_size,
+int initial_capacity, HashTableMatchFunction match);
+
+/*
+ * Deallocates a hash table, with all of its entries (but not what they point
+ * to).
+ * #return:
+ * 	HASH_TABLE_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	HASH_TABLE_SUCCESS - Otherwise.
+ */
+HashTableResult hashTableDestroy(HashTable table);
+
+/*
+ * Creates a copy of a hash table. The entries are copied as they are.
+ * #return:
+ * 	NULL if a NULL pointer was sent or an allocation has failed,
+ * 	and a copy of the table otherwise.
+ */
+HashTable hashTableCopy(HashTable table);
+
+/*
+ * Adds a new entry to the table, and returns it so the user can fill it.
+ * 	$result: Holds the result of the function. Can be sent as NULL if it is
+ * 	not needed.
+ * 	$hash: The hash value of the key.
+ * 	$key: The key, as it's sent to the table's match function.
+ * The new entry is zeroed. It has to get the key before the table is used
+ * again, since the table finds it by it.
+ * #return:
+ * 	NULL if a NULL pointer was sent (HASH_TABLE_NULL_PARAMETER), the key is
+ * 	already in the table (HASH_TABLE_KEY_EXISTS) or an allocation has failed
+ * 	(HASH_TABLE_OUT_OF_MEMORY, and the table is left unchanged),
+ * 	and the new entry otherwise. It stays valid until the table is changed.
+ */
+void* hashTableInsert(HashTableResult* result, HashTable table,
+unsigned int hash, void* key);
+
+/*
+ * Finds the entry of a key.
+ * 	$hash: The hash value of the key.
+ * 	$key: The key, as it's sent to the table's match function.
+ * #return:
+ * 	NULL if a NULL pointer was sent or the key isn't in the table,
+ * 	and the key's entry otherwise. It stays valid until the table is changed.
+ */
+void* hashTableFind(HashTable table, unsigned int hash, void* key);
+
+/*
+ * Removes an entry from the table.
+ * 	$entry: An entry that was returned by the table (since it was last
+ * 	changed).
+ * #return:
+ * 	HASH_TABLE_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	HASH_TABLE_ENTRY_DOES_NOT_EXIST - If the entry isn't one of the table's,
+ * 	HASH_TABLE_SUCCESS - Otherwise.
+ */
+HashTableResult hashTableRemove(HashTable table, void* entry);
+
+/*
+ * Returns the amount of entries in the table.
+ * #return:
+ * 	-1 - If a NULL pointer was sent,
+ * 	and the amount of entries otherwise.
+ */
+int hashTableGetSize(HashTable table);
+
+/*
+ * Calculates the hash value of an integer key (multiplicative hashing).
+ */
+unsigned int hashTableHashInt(int key);
+
+#endif /* HASHTABLE_H_ */
@@ -0,0 +1,521 @@
+#define _POSIX_C_SOURCE 200809L //For fsync, fork, waitpid, open_memstream...
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <pthread.h>
+#include "Journal.h"
+
+/*
+ * Implementation of the Journal ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "Journal".
+ * Every line of the journal file is a command, preceded by its number. The
+ * snapshot file holds the number of the last command it has, and then the
+ * system's image (as written by escapeTechnionSave).
+ * A snapshot is written to memory by the process itself, and only the
+ * writing of that memory to the disk is left to the child process. The
+ * process might have other threads (in server mode), and they might hold
+ * locks of malloc or stdio when it forks, so the child only uses system calls
+ * that are safe after a fork (open, write, fsync, rename and _exit).
+ * In server mode, commands are appended by a few threads at the same time, so
+ * the appending, syncing and snapshot checks are done under the journal's
+ * lock.
+ */
+struct Journal_t {
+	char* path; //The journal file's path.
+	char* snapshot_path; //The snapshot file's path.
+	char* temp_path; //Where new files are written before they replace others.
+	char* directory; //The directory of the journal's files.
+	FILE* file; //The journal file.
+	int sequence; //The number of the last command in the journal.
+	int snapshot_sequence; //The last command in the snapshot.
+	int pending; //The amount of commands that weren't synced yet.
+	int since_snapshot; //The amount of commands since the last snapshot.
+	pid_t snapshot_pid; //The process writing a snapshot (0 if there's none).
+	char* tail; //The commands that came after the snapshot being written.
+	size_t tail_length; //The length of the tail.
+	size_t tail_capacity; //The size of the tail's buffer.
+	char line[MAX_LEN+1]; //The last command line that was read.
+	pthread_mutex_t lock; //Guards the journal while it's appended to.
+};
+
+//The ending of the snapshot file's path.
+#define SNAPSHOT_SUFFIX ".snapshot"
+
+//The ending of the path of a file that's being written.
+#define TEMP_SUFFIX ".tmp"
+
+//The most commands that are synced to the disk together.
+#define GROUP_SIZE 32
+
+//The amount of commands between two snapshots.
+#define SNAPSHOT_INTERVAL 4096
+
+//The longest a journal line can be: a number, a space and a command line.
+#define JOURNAL_LINE_LENGTH (MAX_LEN + 16)
+
+//The initial size of the tail's buffer.
+#define INITIAL_TAIL_CAPACITY 4096
+
+//The tail's buffer grows by this factor each time.
+#define GROWTH_FACTOR 2
+
+//The exit code of a snapshot process that has failed.
+#define SNAPSHOT_FAILED 1
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for assigning a value to a pointer iff it's not NULL.
+ */
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+static char* concatPath(char* path, char* suffix);
+static char* directoryPath(char* path);
+static bool syncFile(FILE* file);
+static void syncDirectory(char* directory);
+static bool addToTail(Journal journal, char* line, size_t length);
+static bool serializeSnapshot(Journal journal, EscapeTechnion system,
+char** image, size_t* size);
+static bool writeSnapshot(Journal journal, char* image, size_t size);
+static void startSnapshot(Journal journal, EscapeTechnion system);
+static JournalResult replaceJournal(Journal journal);
+static JournalResult checkSnapshot(Journal journal, bool wait);
+static JournalResult syncPending(Journal journal);
+static bool snapshotDue(Journal journal);
+static JournalResult appendLine(Journal journal, FieldSlice* words,
+int words_amount);
+
+/*
+ * A static function that allocates a path with a suffix added to it.
+ * #return:
+ * 	NULL if the allocation has failed, and the new path otherwise.
+ */
+static char* concatPath(char* path, char* suffix) {
+	assert(path && suffix);
+	char* new_path = malloc(strlen(path) + strlen(suffix) + 1);
+	CHECK_VALID(new_path, NULL)
+	strcpy(new_path, path);
+	strcat(new_path, suffix);
+	return new_path;
+}
+
+/*
+ * A static function that allocates the path of the directory of a file.
+ * #return:
+ * 	NULL if the allocation has failed, and the directory's path otherwise.
+ */
+static char* directoryPath(char* path) {
+	assert(path);
+	char* separator = strrchr(path, '/');
+	CHECK_VALID(separator, concatPath(".", ""))
+	char* directory = concatPath(path, "");
+	CHECK_VALID(directory, NULL)
+	directory[(separator == path) ? 1 : (separator - path)] = '\0';
+	return directory;
+}
+
+/*
+ * A static function that writes a file's buffer and syncs it to the disk.
+ * #return:
+ * 	false - if it has failed, true - otherwise.
+ */
+static bool syncFile(FILE* file) {
+	assert(file);
+	CHECK_VALID((fflush(file) == 0), false)
+	return (fsync(fileno(file)) == 0);
+}
+
+/*
+ * A static function that syncs a directory, so that a file that was renamed
+ * into it stays renamed after a crash. Failures are ignored (some file systems
+ * can't sync directories). Only uses system calls, so a snapshot's child can
+ * call it.
+ */
+static void syncDirectory(char* directory) {
+	assert(directory);
+	int fd = open(directory, O_RDONLY);
+	if(fd >= 0) {
+		fsync(fd);
+		close(fd);
+	}
+}
+
+/*
+ * A static function that keeps a journal line in the tail (the commands a
+ * running snapshot doesn't have).
+ * #return:
+ * 	false - if an allocation has failed, true - otherwise.
+ */
+static bool addToTail(Journal journal, char* line, size_t length) {
+	assert(journal && line);
+	if(journal->tail_length + length > journal->tail_capacity) {
+		size_t new_capacity = (journal->tail_capacity > 0) ?
+		(journal->tail_capacity) : (INITIAL_TAIL_CAPACITY);
+		while(journal->tail_length + length > new_capacity)
+			new_capacity *= GROWTH_FACTOR;
+		char* new_tail = realloc(journal->tail, new_capacity);
+		CHECK_VALID(new_tail, false)
+		journal->tail = new_tail;
+		journal->tail_capacity = new_capacity;
+	}
+	memcpy(journal->tail + journal->tail_length, line, length);
+	journal->tail_length += length;
+	return true;
+}
+
+/*
+ * A static function that writes a snapshot of the system to memory: the
+ * number of the last command, and then the system's image.
+ * 	$image: Address where the allocated snapshot will be stored.
+ * 	$size: Address where the snapshot's size will be stored.
+ * #return:
+ * 	false - if it has failed, true - otherwise.
+ */
+static bool serializeSnapshot(Journal journal, EscapeTechnion system,
+char** image, size_t* size) {
+	assert(journal && system && image && size);
+	*image = NULL;
+	FILE* memory = open_memstream(image, size);
+	CHECK_VALID(memory, false)
+	Checkpoint checkpoint = checkpointCreate(memory);
+	bool written = (checkpoint != NULL);
+	if(written) {
+		checkpointWriteInt(checkpoint, journal->sequence);
+		written = (checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS);
+		checkpointDestroy(checkpoint);
+	}
+	written = written &&
+	(escapeTechnionSave(system, memory) == ESCAPE_TECHNION_SUCCESS);
+	written = (fclose(memory) == 0) && written;
+	if(!written) {
+		free(*image);
+		*image = NULL;
+	}
+	return written;
+}
+
+/*
+ * A static function that writes a snapshot from memory to the disk: the
+ * snapshot is written to the temporary path, synced, and only then replaces
+ * the previous snapshot, so there's always a whole snapshot on the disk.
+ * Only uses system calls, since it's called by the snapshot's child.
+ * #return:
+ * 	false - if it has failed, true - otherwise.
+ */
+static bool writeSnapshot(Journal journal, char* image, size_t size) {
+	assert(journal && image);
+	int fd = open(journal->temp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	CHECK_VALID((fd >= 0), false)
+	size_t written = 0;
+	while(written < size) {
+		ssize_t amount = write(fd, image + written, size - written);
+		if(amount <= 0)
+			break;
+		written += (size_t)amount;
+	}
+	bool synced = (written == size) && (fsync(fd) == 0);
+	synced = (close(fd) == 0) && synced;
+	CHECK_VALID(synced, false)
+	CHECK_VALID((rename(journal->temp_path, journal->snapshot_path) == 0),
+	false)
+	syncDirectory(journal->directory);
+	return true;
+}
+
+/*
+ * A static function that starts a snapshot: the system is written to memory
+ * as it is now (the caller holds the system, so no command changes it in the
+ * middle), and a child process writes that memory to the disk while the
+ * system keeps working. If the snapshot can't be written to memory or the
+ * child can't be created, the snapshot is skipped until the next interval.
+ */
+static void startSnapshot(Journal journal, EscapeTechnion system) {
+	assert(journal && system && (journal->snapshot_pid == 0));
+	journal->since_snapshot = 0;
+	char* image = NULL;
+	size_t size = 0;
+	if(!serializeSnapshot(journal, system, &image, &size))
+		return;
+	pid_t pid = fork();
+	if(pid == 0) {
+		//The child only writes the snapshot. It leaves with _exit, so the
+		//parent's files and buffers are left alone.
+		_exit(writeSnapshot(journal, image, size) ? 0 : SNAPSHOT_FAILED);
+	}
+	free(image);
+	if(pid < 0)
+		return;
+	journal->snapshot_pid = pid;
+	journal->snapshot_sequence = journal->sequence;
+	journal->tail_length = 0;
+}
+
+/*
+ * A static function that replaces the journal file with the tail: the
+ * commands that came after the snapshot that was just written.
+ * #return:
+ * 	JOURNAL_FILE_ERROR - if the new journal couldn't be written (the previous
+ * 	journal is kept, so no command is lost),
+ * 	JOURNAL_SUCCESS - otherwise.
+ */
+static JournalResult replaceJournal(Journal journal) {
+	assert(journal);
+	CHECK_VALID(syncFile(journal->file), JOURNAL_FILE_ERROR)
+	FILE* new_file = fopen(journal->temp_path, "w");
+	CHECK_VALID(new_file, JOURNAL_FILE_ERROR)
+	//The tail has no buffer if no command came after the snapshot.
+	bool written = ((journal->tail_length == 0) || (fwrite(journal->tail, 1,
+	journal->tail_length, new_file) == journal->tail_length)) &&
+	syncFile(new_file);
+	written = (fclose(new_file) == 0) && written;
+	CHECK_VALID(written, JOURNAL_FILE_ERROR)
+	CHECK_VALID((rename(journal->temp_path, journal->path) == 0),
+	JOURNAL_FILE_ERROR)
+	syncDirectory(journal->directory);
+	fclose(journal->file);
+	journal->file = fopen(journal->path, "a+");
+	CHECK_VALID(journal->file, JOURNAL_FILE_ERROR)
+	journal->pending = 0;
+	return JOURNAL_SUCCESS;
+}
+
+/*
+ * A static function that checks if the running snapshot is done (or waits
+ * for it), and if it was written - cuts the journal down to the tail.
+ */
+static JournalResult checkSnapshot(Journal journal, bool wait) {
+	assert(journal);
+	CHECK_VALID((journal->snapshot_pid != 0), JOURNAL_SUCCESS)
+	int status = 0;
+	pid_t done = waitpid(journal->snapshot_pid, &status, wait ? 0 : WNOHANG);
+	CHECK_VALID((done != 0), JOURNAL_SUCCESS)
+	journal->snapshot_pid = 0;
+	bool written = (done > 0) && WIFEXITED(status) &&
+	(WEXITSTATUS(status) == 0);
+	JournalResult result = written ? replaceJournal(journal) : JOURNAL_SUCCESS;
+	journal->tail_length = 0;
+	return result;
+}
+
+/*
+ * A static function that syncs the commands that were appended (and weren't
+ * synced yet) to the disk.
+ */
+static JournalResult syncPending(Journal journal) {
+	assert(journal);
+	CHECK_VALID((journal->pending > 0), JOURNAL_SUCCESS)
+	CHECK_VALID(syncFile(journal->file), JOURNAL_FILE_ERROR)
+	journal->pending = 0;
+	return JOURNAL_SUCCESS;
+}
+
+/*
+ * A static function that checks if enough commands were appended for a new
+ * snapshot, and there's no snapshot being written.
+ */
+static bool snapshotDue(Journal journal) {
+	assert(journal);
+	return ((journal->since_snapshot >= SNAPSHOT_INTERVAL) &&
+	(journal->snapshot_pid == 0));
+}
+
+/*
+ * A static function that appends a command line to the journal (the journal's
+ * lock is held by the caller).
+ */
+static JournalResult appendLine(Journal journal, FieldSlice* words,
+int words_amount) {
+	assert(journal && words);
+	JournalResult result = checkSnapshot(journal, false);
+	CHECK_VALID((result == JOURNAL_SUCCESS), result)
+	char line[JOURNAL_LINE_LENGTH+1];
+	int length = sprintf(line, "%d", journal->sequence + 1);
+	//The command starts after the space that follows the number, and has to
+	//fit in a command line when it's read back.
+	int command_start = length+1;
+	for(int i=0; i<words_amount; i++) {
+		CHECK_VALID((length + words[i].length + 1 - command_start <= MAX_LEN),
+		JOURNAL_FILE_ERROR)
+		line[length++] = ' ';
+		memcpy(line+length, words[i].start, words[i].length);
+		length += words[i].length;
+	}
+	line[length++] = '\n';
+	line[length] = '\0';
+	if(journal->snapshot_pid != 0)
+		CHECK_VALID(addToTail(journal, line, length), JOURNAL_OUT_OF_MEMORY)
+	CHECK_VALID((fputs(line, journal->file) >= 0), JOURNAL_FILE_ERROR)
+	(journal->sequence)++;
+	(journal->since_snapshot)++;
+	if(++(journal->pending) >= GROUP_SIZE)
+		CHECK_VALID((syncPending(journal) == JOURNAL_SUCCESS),
+		JOURNAL_FILE_ERROR)
+	return JOURNAL_SUCCESS;
+}
+
+Journal journalCreate(JournalResult* result, char* path) {
+	INIT_IF_EXISTS(result, JOURNAL_NULL_PARAMETER)
+	CHECK_VALID(path, NULL)
+	INIT_IF_EXISTS(result, JOURNAL_OUT_OF_MEMORY)
+	Journal journal = malloc(sizeof(*journal));
+	CHECK_VALID(journal, NULL)
+	journal->path = concatPath(path, "");
+	journal->snapshot_path = concatPath(path, SNAPSHOT_SUFFIX);
+	journal->temp_path = concatPath(path, TEMP_SUFFIX);
+	journal->directory = directoryPath(path);
+	journal->file = NULL;
+	journal->tail = NULL;
+	if(journal->path && journal->snapshot_path && journal->temp_path &&
+	journal->directory) {
+		//The journal is read (for recovery) before it's appended to.
+		journal->file = fopen(path, "a+");
+		INIT_IF_EXISTS(result, JOURNAL_FILE_ERROR)
+	}
+	if(!(journal->file)) {
+		free(journal->path);
+		free(journal->snapshot_path);
+		free(journal->temp_path);
+		free(journal->directory);
+		free(journal);
+		return NULL;
+	}
+	rewind(journal->file);
+	journal->sequence = 0;
+	journal->snapshot_sequence = 0;
+	journal->pending = 0;
+	journal->since_snapshot = 0;
+	journal->snapshot_pid = 0;
+	journal->tail_length = 0;
+	journal->tail_capacity = 0;
+	journal->line[0] = '\0';
+	pthread_mutex_init(&(journal->lock), NULL);
+	INIT_IF_EXISTS(result, JOURNAL_SUCCESS)
+	return journal;
+}
+
+JournalResult journalDestroy(Journal journal) {
+	CHECK_VALID(journal, JOURNAL_NULL_PARAMETER)
+	JournalResult result = journalCommit(journal);
+	JournalResult snapshot_result = checkSnapshot(journal, true);
+	if(result == JOURNAL_SUCCESS)
+		result = snapshot_result;
+	fclose(journal->file);
+	free(journal->tail);
+	free(journal->path);
+	free(journal->snapshot_path);
+	free(journal->temp_path);
+	free(journal->directory);
+	pthread_mutex_destroy(&(journal->lock));
+	free(journal);
+	return result;
+}
+
+EscapeTechnion journalRecover(Journal journal, JournalResult* result) {
+	INIT_IF_EXISTS(result, JOURNAL_NULL_PARAMETER)
+	CHECK_VALID(journal, NULL)
+	INIT_IF_EXISTS(result, JOURNAL_SUCCESS)
+	FILE* file = fopen(journal->snapshot_path, "rb");
+	if(!file) {
+		EscapeTechnion system = escapeTechnionCreate();
+		INIT_IF_EXISTS(result, system ? JOURNAL_SUCCESS : JOURNAL_OUT_OF_MEMORY)
+		return system;
+	}
+	Checkpoint checkpoint = checkpointCreate(file);
+	if(!checkpoint) {
+		fclose(file);
+		INIT_IF_EXISTS(result, JOURNAL_OUT_OF_MEMORY)
+		return NULL;
+	}
+	int sequence = 0;
+	checkpointReadInt(checkpoint, &sequence);
+	bool valid = (checkpointGetResult(checkpoint) == CHECKPOINT_SUCCESS) &&
+	(sequence >= 0);
+	checkpointDestroy(checkpoint);
+	EscapeTechnionResult load_result = ESCAPE_TECHNION_CHECKPOINT_FAILED;
+	EscapeTechnion system = valid ? escapeTechnionLoad(&load_result, file) :
+	NULL;
+	fclose(file);
+	if(!system) {
+		INIT_IF_EXISTS(result, (load_result == ESCAPE_TECHNION_OUT_OF_MEMORY) ?
+		(JOURNAL_OUT_OF_MEMORY) : (JOURNAL_INVALID_SNAPSHOT))
+		return NULL;
+	}
+	journal->sequence = sequence;
+	journal->snapshot_sequence = sequence;
+	return system;
+}
+
+char* journalNextCommand(Journal journal) {
+	CHECK_VALID(journal, NULL)
+	char line[JOURNAL_LINE_LENGTH+1];
+	long line_start = ftell(journal->file);
+	while(fgets(line, JOURNAL_LINE_LENGTH+1, journal->file)) {
+		char* command = NULL;
+		long sequence = strtol(line, &command, 10);
+		size_t length = strlen(line);
+		if((length == 0) || (line[length-1] != '\n') || (command == line) ||
+		(*command != ' ') || (sequence <= 0))
+			break; //The rest of the journal was cut by a crash.
+		//The command is kept without the line's ending.
+		size_t command_length = length - (command+1-line) - 1;
+		if(command_length > MAX_LEN)
+			break;
+		line_start = ftell(journal->file);
+		if(sequence <= journal->sequence)
+			continue; //The snapshot already has this command.
+		journal->sequence = (int)sequence;
+		memcpy(journal->line, command+1, command_length);
+		journal->line[command_length] = '\0';
+		return journal->line;
+	}
+	//The commands ran out. Whatever comes after the last whole command is
+	//erased, and the journal is ready for new commands.
+	fflush(journal->file);
+	if((line_start >= 0) && (ftruncate(fileno(journal->file),
+	(off_t)line_start) == 0))
+		fseek(journal->file, 0, SEEK_END);
+	return NULL;
+}
+
+JournalResult journalAppend(Journal journal, FieldSlice* words,
+int words_amount) {
+	CHECK_VALID(journal && words, JOURNAL_NULL_PARAMETER)
+	pthread_mutex_lock(&(journal->lock));
+	JournalResult result = appendLine(journal, words, words_amount);
+	pthread_mutex_unlock(&(journal->lock));
+	return result;
+}
+
+JournalResult journalCommit(Journal journal) {
+	CHECK_VALID(journal, JOURNAL_NULL_PARAMETER)
+	pthread_mutex_lock(&(journal->lock));
+	JournalResult result = syncPending(journal);
+	pthread_mutex_unlock(&(journal->lock));
+	return result;
+}
+
+bool journalSnapshotDue(Journal journal) {
+	CHECK_VALID(journal, false)
+	pthread_mutex_lock(&(journal->lock));
+	bool due = snapshotDue(journal);
+	pthread_mutex_unlock(&(journal->lock));
+	return due;
+}
+
+JournalResult journalSnapshot(Journal journal, EscapeTechnion system) {
+	CHECK_VALID(journal && system, JOURNAL_NULL_PARAMETER)
+	pthread_mutex_lock(&(journal->lock));
+	if(snapshotDue(journal))
+		startSnapshot(journal, system);
+	pthread_mutex_unlock(&(journal->lock));
+	return JOURNAL_SUCCESS;
+}
@@ -0,0 +1,128 @@
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "EscapeTechnion.h"
+#include "Checkpoint.h"
+#include "Field.h"
+
+typedef struct Journal_t *Journal; //Name of the ADT.
+
+typedef enum {
+	//The journal's errors:
+	JOURNAL_SUCCESS,
+	JOURNAL_NULL_PARAMETER,
+	JOURNAL_OUT_OF_MEMORY,
+	JOURNAL_FILE_ERROR,
+	JOURNAL_INVALID_SNAPSHOT,
+} JournalResult;
+
+/*
+ * Opens (or creates) a journal.
+ * A journal makes a system durable: every command that changed the system is
+ * appended to the journal file, and from time to time a snapshot of the whole
+ * system is written next to it (to the same path, followed by ".snapshot").
+ * After a crash, the system is recovered by loading the snapshot and then
+ * replaying only the commands that came after it.
+ * The commands are synced to the disk in groups (and not one by one), so a
+ * crash loses at most the last group of commands. A command that's
+ * acknowledged on its own (like a line a client sent) should be synced with
+ * journalCommit before it's acknowledged. A snapshot is written to memory
+ * first, and then to the disk by a child process, so the system keeps working
+ * while it's written, and the journal is cut down to the commands the
+ * snapshot doesn't have once it's done.
+ * 	$result: Holds the result of the create function. Can be sent as NULL if
+ * 	the result of this function is not needed.
+ * 	$path: The path of the journal file.
+ * #return:
+ * 	NULL if a NULL pointer was sent, an allocation has failed or the journal
+ * 	file couldn't be opened,
+ * 	and a new journal otherwise.
+ */
+Journal journalCreate(JournalResult* result, char* path);
+
+/*
+ * Closes a journal. The commands that weren't synced yet are synced, and if a
+ * snapshot is being written - it's waited for.
+ * #return:
+ * 	JOURNAL_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	JOURNAL_FILE_ERROR - If the last commands couldn't be synced,
+ * 	JOURNAL_SUCCESS - Otherwise.
+ */
+JournalResult journalDestroy(Journal journal);
+
+/*
+ * Creates the system the journal starts from: the system in the journal's
+ * snapshot, or a new system if there's no snapshot yet. The commands that come
+ * after the snapshot are then read with journalNextCommand.
+ * 	$result: Holds the result of the function. Can be sent as NULL if the
+ * 	result of this function is not needed.
+ * #return:
+ * 	NULL if a NULL pointer was sent, an allocation has failed or the snapshot
+ * 	is broken (JOURNAL_INVALID_SNAPSHOT),
+ * 	and the system otherwise.
+ */
+EscapeTechnion journalRecover(Journal journal, JournalResult* result);
+
+/*
+ * Reads the next command to replay: a command that's in the journal but not
+ * in the snapshot. Once the commands run out, the journal is ready for new
+ * commands. A command that was cut in the middle by a crash (the last one) is
+ * erased from the journal.
+ * #return:
+ * 	NULL if a NULL pointer was sent or there are no more commands,
+ * 	and the command line otherwise. The line is kept in the journal's buffer,
+ * 	and is valid until the next call.
+ */
+char* journalNextCommand(Journal journal);
+
+/*
+ * Appends a command that changed the system to the journal. Every few commands
+ * the journal is synced to the disk (journalCommit syncs it sooner). Commands
+ * can be appended by a few threads at the same time, and they're kept in the
+ * order they were appended in, so commands that depend on each other have to
+ * be appended in the order they were executed in.
+ * 	$words: The words of the command line (slices of it, see Field.h).
+ * 	$words_amount: The amount of words.
+ * #return:
+ * 	JOURNAL_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	JOURNAL_OUT_OF_MEMORY - If an allocation has failed,
+ * 	JOURNAL_FILE_ERROR - If writing to the journal has failed,
+ * 	JOURNAL_SUCCESS - Otherwise.
+ */
+JournalResult journalAppend(Journal journal, FieldSlice* words,
+int words_amount);
+
+/*
+ * Checks if a new snapshot of the system is due: every few thousands commands
+ * (unless the last snapshot is still being written).
+ * #return:
+ * 	false if a NULL pointer was sent or no snapshot is due, true otherwise.
+ */
+bool journalSnapshotDue(Journal journal);
+
+/*
+ * Starts a new snapshot of the system, if one is due (see journalSnapshotDue).
+ * 	$system: The system, after all the commands that were appended have
+ * 	changed it. The snapshot reads it, so no other thread may change it (or
+ * 	append to the journal) until this function returns.
+ * #return:
+ * 	JOURNAL_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	JOURNAL_SUCCESS - Otherwise (a snapshot that fails is tried again later).
+ */
+JournalResult journalSnapshot(Journal journal, EscapeTechnion system);
+
+/*
+ * Syncs all the commands that were appended to the disk.
+ * #return:
+ * 	JOURNAL_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	JOURNAL_FILE_ERROR - If writing to the journal has failed,
+ * 	JOURNAL_SUCCESS - Otherwise.
+ */
+JournalResult journalCommit(Journal journal);
+
+#endif /* JOURNAL_H_ */
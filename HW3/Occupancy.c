@@ -0,0 +1,142 @@
+#include "Occupancy.h"
+
+/*
+ * An entry of the map: a day and the mask of its reserved hours.
+ */
+typedef struct DayMask_t {
+	int day; //The day.
+	unsigned int mask; //The reserved hours of the day (bit h = hour h).
+} DayMask;
+
+/*
+ * Implementation of the Occupancy ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "Occupancy".
+ * The map is a hash table of day masks (see HashTable.h). A day whose mask
+ * becomes empty is removed from it.
+ */
+struct Occupancy_t {
+	HashTable days; //The days that have reservations, and their masks.
+};
+
+//Total amount of hours in one day.
+#define HOURS_IN_A_DAY 24
+
+//The initial amount of slots in a map's table. Must be a power of 2.
+#define INITIAL_CAPACITY 8
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for the bit of an hour in a day's mask.
+ */
+#define HOUR_BIT(hour) (1u << (hour))
+
+static bool validTime(int day, int hour);
+static bool matchDay(void* entry, void* day);
+static DayMask* findDay(Occupancy occupancy, int day);
+
+/*
+ * A static function that checks that a day and an hour are valid.
+ */
+static bool validTime(int day, int hour) {
+	return ((day >= 0) && (hour >= 0) && (hour < HOURS_IN_A_DAY));
+}
+
+/*
+ * A static function that checks whether a day mask is of a day (the match
+ * function of the map's table).
+ */
+static bool matchDay(void* entry, void* day) {
+	return (((DayMask*)entry)->day == *(int*)day);
+}
+
+/*
+ * A static function that finds the mask of a day in the map.
+ * #return:
+ * 	NULL if the day has no reservations, and its mask's entry otherwise.
+ */
+static DayMask* findDay(Occupancy occupancy, int day) {
+	assert(occupancy);
+	return hashTableFind(occupancy->days, hashTableHashInt(day), &day);
+}
+
+Occupancy occupancyCreate() {
+	Occupancy occupancy = malloc(sizeof(*occupancy));
+	CHECK_VALID(occupancy, NULL)
+	occupancy->days = hashTableCreate(NULL, sizeof(DayMask), INITIAL_CAPACITY,
+	matchDay);
+	if(!(occupancy->days)) {
+		free(occupancy);
+		return NULL;
+	}
+	return occupancy;
+}
+
+OccupancyResult occupancyDestroy(Occupancy occupancy) {
+	CHECK_VALID(occupancy, OCCUPANCY_NULL_PARAMETER)
+	hashTableDestroy(occupancy->days);
+	free(occupancy);
+	return OCCUPANCY_SUCCESS;
+}
+
+Occupancy occupancyCopy(Occupancy occupancy) {
+	CHECK_VALID(occupancy, NULL)
+	Occupancy occupancy_copy = malloc(sizeof(*occupancy_copy));
+	CHECK_VALID(occupancy_copy, NULL)
+	//The masks don't point anywhere, so the table is copied as is.
+	occupancy_copy->days = hashTableCopy(occupancy->days);
+	if(!(occupancy_copy->days)) {
+		free(occupancy_copy);
+		return NULL;
+	}
+	return occupancy_copy;
+}
+
+OccupancyResult occupancyReserve(Occupancy occupancy, int day, int hour) {
+	CHECK_VALID(occupancy, OCCUPANCY_NULL_PARAMETER)
+	CHECK_VALID(validTime(day, hour), OCCUPANCY_INVALID_PARAMETER)
+	DayMask* entry = findDay(occupancy, day);
+	if(entry) {
+		CHECK_VALID(!(entry->mask & HOUR_BIT(hour)), OCCUPANCY_HOUR_RESERVED)
+		entry->mask |= HOUR_BIT(hour);
+		return OCCUPANCY_SUCCESS;
+	}
+	entry = hashTableInsert(NULL, occupancy->days, hashTableHashInt(day),
+	&day);
+	CHECK_VALID(entry, OCCUPANCY_OUT_OF_MEMORY)
+	entry->day = day;
+	entry->mask = HOUR_BIT(hour);
+	return OCCUPANCY_SUCCESS;
+}
+
+OccupancyResult occupancyRelease(Occupancy occupancy, int day, int hour) {
+	CHECK_VALID(occupancy, OCCUPANCY_NULL_PARAMETER)
+	CHECK_VALID(validTime(day, hour), OCCUPANCY_INVALID_PARAMETER)
+	DayMask* entry = findDay(occupancy, day);
+	CHECK_VALID((entry && (entry->mask & HOUR_BIT(hour))), OCCUPANCY_HOUR_FREE)
+	entry->mask &= ~HOUR_BIT(hour);
+	if(entry->mask == 0)
+		//The day has no more reservations, so it leaves the table.
+		hashTableRemove(occupancy->days, entry);
+	return OCCUPANCY_SUCCESS;
+}
+
+bool occupancyIsReserved(Occupancy occupancy, int day, int hour) {
+	CHECK_VALID(occupancy, false)
+	CHECK_VALID(validTime(day, hour), false)
+	return ((occupancyGetDay(occupancy, day) & HOUR_BIT(hour)) != 0);
+}
+
+unsigned int occupancyGetDay(Occupancy occupancy, int day) {
+	CHECK_VALID(occupancy, 0)
+	CHECK_VALID((day >= 0), 0)
+	DayMask* entry = findDay(occupancy, day);
+	return (entry) ? (entry->mask) : (0);
+}
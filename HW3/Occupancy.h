@@ -0,0 +1,90 @@
+#ifndef OCCUPANCY_H_
+#define OCCUPANCY_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "HashTable.h"
+
+typedef struct Occupancy_t *Occupancy; //Name of the ADT.
+
+typedef enum {
+	//The occupancy's errors:
+	OCCUPANCY_SUCCESS,
+	OCCUPANCY_NULL_PARAMETER,
+	OCCUPANCY_INVALID_PARAMETER,
+	OCCUPANCY_OUT_OF_MEMORY,
+	OCCUPANCY_HOUR_RESERVED,
+	OCCUPANCY_HOUR_FREE,
+} OccupancyResult;
+
+/*
+ * Allocates a new, empty occupancy map.
+ * The map holds the reserved hours of a room (or of an escaper): for every day
+ * that has reservations, it keeps a mask of 24 bits, where bit h is on iff the
+ * hour h of that day is reserved. Days without reservations take no space.
+ * #return:
+ * 	NULL if an allocation has failed,
+ * 	and a new occupancy map otherwise.
+ */
+Occupancy occupancyCreate();
+
+/*
+ * Deallocates an occupancy map.
+ * #return:
+ * 	OCCUPANCY_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	OCCUPANCY_SUCCESS - Otherwise.
+ */
+OccupancyResult occupancyDestroy(Occupancy occupancy);
+
+/*
+ * Creates a copy of the target occupancy map.
+ * #return:
+ * 	NULL if a NULL pointer was sent or a memory allocation failed,
+ * 	and a new copy of the map otherwise.
+ */
+Occupancy occupancyCopy(Occupancy occupancy);
+
+/*
+ * Marks an hour as reserved.
+ * 	$day: The day (counted from the system's first day). Must be non-negative.
+ * 	$hour: The hour of the day. Must be between 0 and 23.
+ * #return:
+ * 	OCCUPANCY_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	OCCUPANCY_INVALID_PARAMETER - If the day or the hour are invalid,
+ * 	OCCUPANCY_HOUR_RESERVED - If the hour is already reserved,
+ * 	OCCUPANCY_OUT_OF_MEMORY - If an allocation has failed,
+ * 	OCCUPANCY_SUCCESS - Otherwise.
+ */
+OccupancyResult occupancyReserve(Occupancy occupancy, int day, int hour);
+
+/*
+ * Marks a reserved hour as free again.
+ * #return:
+ * 	OCCUPANCY_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	OCCUPANCY_INVALID_PARAMETER - If the day or the hour are invalid,
+ * 	OCCUPANCY_HOUR_FREE - If the hour isn't reserved,
+ * 	OCCUPANCY_SUCCESS - Otherwise.
+ */
+OccupancyResult occupancyRelease(Occupancy occupancy, int day, int hour);
+
+/*
+ * Checks if an hour is reserved.
+ * #return:
+ * 	false - If a NULL pointer was sent, the day or hour are invalid or the hour
+ * 	is free,
+ * 	true - Otherwise.
+ */
+bool occupancyIsReserved(Occupancy occupancy, int day, int hour);
+
+/*
+ * Returns the mask of the reserved hours of a day (bit h is on iff the hour h
+ * is reserved).
+ * #return:
+ * 	0 - If a NULL pointer was sent or the day has no reservations,
+ * 	and the day's mask otherwise.
+ */
+unsigned int occupancyGetDay(Occupancy occupancy, int day);
+
+#endif /* OCCUPANCY_H_ */
@@ -0,0 +1,137 @@
+#define _POSIX_C_SOURCE 200112L //For pthreads.
+#include <pthread.h>
+#include "Pool.h"
+
+/*
+ * A free object of the pool. The free objects are linked through their own
+ * memory, so the list of free objects takes no extra space.
+ */
+typedef struct FreeObject_t {
+	struct FreeObject_t* next; //The next free object.
+} FreeObject;
+
+/*
+ * A slab of objects. The objects come right after the slab's header.
+ */
+typedef struct Slab_t {
+	struct Slab_t* next; //The slab that was allocated before this one.
+} Slab;
+
+/*
+ * Implementation of the Pool ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "Pool".
+ */
+struct Pool_t {
+	size_t object_size; //The size of every object (rounded up, see below).
+	Slab* slabs; //The slabs of the pool, from the newest to the oldest.
+	FreeObject* free_objects; //The objects that were given back.
+	char* next_object; //The next object that wasn't handed out yet.
+	char* slab_end; //The end of the newest slab.
+	pthread_mutex_t lock; //Guards the objects while they're handed out.
+};
+
+//The amount of objects in every slab.
+#define OBJECTS_IN_A_SLAB 256
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+static size_t alignedSize(size_t size);
+static bool addSlab(Pool pool);
+
+/*
+ * A static function that rounds a size up to the alignment of the objects, so
+ * every object in a slab is aligned like malloc's memory, and is big enough
+ * to hold a free object.
+ */
+static size_t alignedSize(size_t size) {
+	size_t alignment = sizeof(long double);
+	if(size < sizeof(FreeObject))
+		size = sizeof(FreeObject);
+	return ((size + alignment - 1) / alignment) * alignment;
+}
+
+/*
+ * A static function that allocates a new slab, and makes it the slab from
+ * which new objects are handed out.
+ * #return:
+ * 	false if an allocation has failed, and true otherwise.
+ */
+static bool addSlab(Pool pool) {
+	assert(pool);
+	size_t header = alignedSize(sizeof(Slab));
+	Slab* slab = malloc(header + OBJECTS_IN_A_SLAB * pool->object_size);
+	CHECK_VALID(slab, false)
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+	pool->next_object = (char*)slab + header;
+	pool->slab_end = pool->next_object + OBJECTS_IN_A_SLAB * pool->object_size;
+	return true;
+}
+
+Pool poolCreate(PoolResult* result, size_t object_size) {
+	if(object_size == 0) {
+		INIT_IF_EXISTS(result, POOL_INVALID_PARAMETER);
+		return NULL;
+	}
+	Pool pool = malloc(sizeof(*pool));
+	if(!pool) {
+		INIT_IF_EXISTS(result, POOL_OUT_OF_MEMORY);
+		return NULL;
+	}
+	pool->object_size = alignedSize(object_size);
+	pool->slabs = NULL;
+	pool->free_objects = NULL;
+	pool->next_object = NULL;
+	pool->slab_end = NULL;
+	pthread_mutex_init(&(pool->lock), NULL);
+	INIT_IF_EXISTS(result, POOL_SUCCESS);
+	return pool;
+}
+
+PoolResult poolDestroy(Pool pool) {
+	CHECK_VALID(pool, POOL_NULL_PARAMETER)
+	while(pool->slabs) {
+		Slab* next = pool->slabs->next;
+		free(pool->slabs);
+		pool->slabs = next;
+	}
+	pthread_mutex_destroy(&(pool->lock));
+	free(pool);
+	return POOL_SUCCESS;
+}
+
+void* poolAlloc(Pool pool) {
+	CHECK_VALID(pool, NULL)
+	void* object = NULL;
+	pthread_mutex_lock(&(pool->lock));
+	if(pool->free_objects) {
+		object = pool->free_objects;
+		pool->free_objects = pool->free_objects->next;
+	}
+	else if((pool->next_object != pool->slab_end) || addSlab(pool)) {
+		object = pool->next_object;
+		pool->next_object += pool->object_size;
+	}
+	pthread_mutex_unlock(&(pool->lock));
+	return object;
+}
+
+PoolResult poolFree(Pool pool, void* object) {
+	CHECK_VALID((pool && object), POOL_NULL_PARAMETER)
+	FreeObject* free_object = object;
+	pthread_mutex_lock(&(pool->lock));
+	free_object->next = pool->free_objects;
+	pool->free_objects = free_object;
+	pthread_mutex_unlock(&(pool->lock));
+	return POOL_SUCCESS;
+}
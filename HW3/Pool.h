@@ -0,0 +1,63 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+
+typedef struct Pool_t *Pool; //Name of the ADT.
+
+typedef enum {
+	//The pool's errors:
+	POOL_SUCCESS,
+	POOL_NULL_PARAMETER,
+	POOL_INVALID_PARAMETER,
+	POOL_OUT_OF_MEMORY,
+} PoolResult;
+
+/*
+ * Allocates a new, empty pool of objects of one size.
+ * The pool takes its memory in big slabs (of a few hundreds of objects each),
+ * and hands out the objects one by one. A freed object is kept in the pool and
+ * is handed out again, so creating and destroying many small objects doesn't
+ * call malloc and free for every one of them. The slabs are freed all together
+ * when the pool is destroyed.
+ * Objects can be taken and given back by several threads at the same time:
+ * the pool holds its lock only while it hands out or takes back an object.
+ * 	$result: Holds the result of the create function. Can be sent as NULL if
+ * 	the result of this function is not needed.
+ * 	$object_size: The size of every object in the pool. Must be positive.
+ * #return:
+ * 	NULL if the size is invalid or an allocation has failed,
+ * 	and a new pool otherwise.
+ */
+Pool poolCreate(PoolResult* result, size_t object_size);
+
+/*
+ * Deallocates a pool, together with all of its objects (including the ones
+ * that weren't freed).
+ * #return:
+ * 	POOL_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	POOL_SUCCESS - Otherwise.
+ */
+PoolResult poolDestroy(Pool pool);
+
+/*
+ * Takes an object from the pool. A new slab is allocated if the pool has no
+ * free objects.
+ * #return:
+ * 	NULL if a NULL pointer was sent or an allocation has failed,
+ * 	and the object otherwise. Its content is undefined.
+ */
+void* poolAlloc(Pool pool);
+
+/*
+ * Gives an object back to the pool, so it can be handed out again.
+ * 	$object: An object that was taken from this pool (and wasn't given back).
+ * #return:
+ * 	POOL_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	POOL_SUCCESS - Otherwise.
+ */
+PoolResult poolFree(Pool pool, void* object);
+
+#endif /* POOL_H_ */
@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200112L //For write and fileno.
+#include <errno.h>
+#include <unistd.h>
+#include "ReportWriter.h"
+
+/*
+ * Implementation of the ReportWriter ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "ReportWriter".
+ */
+struct ReportWriter_t {
+	char* buffer; //The text that wasn't written yet.
+	size_t length; //The length of the text in the buffer.
+	size_t capacity; //The size of the buffer.
+	FILE* channel; //The output channel.
+};
+
+//The initial size of the buffer. Every single part of a report fits in it.
+#define INITIAL_CAPACITY (64*1024)
+
+//The buffer grows by this factor each time.
+#define GROWTH_FACTOR 2
+
+//The most characters an int can take (a sign and 10 digits).
+#define MAX_INT_LENGTH 11
+
+//The most characters a faculty's name can take.
+#define MAX_FACULTY_LENGTH 64
+
+//The faculty name the printers use for a faculty that isn't in the list.
+#define UNKNOWN_FACULTY_NAME "UNKNOWN FACULTY"
+
+/*
+ * The names of the faculties, in the order of the TechnionFaculty enum, as the
+ * printers print them.
+ */
+static const char* faculty_names[UNKNOWN] = {
+	"Civil and Environmental Engineering",
+	"Mechanical Engineering",
+	"Electrical Engineering",
+	"Chemical Engineering",
+	"Biotechnology and Food Engineering",
+	"Aerospace Engineering",
+	"Industrial Engineering and Management",
+	"Mathematics",
+	"Physics",
+	"Chemistry",
+	"Biology",
+	"Architecture and Town Planning",
+	"Education in Technology and Science",
+	"Computer Science",
+	"Medicine",
+	"Materials Engineering",
+	"Humanities and Arts",
+	"Biomedical Engineering"
+};
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for adding a string literal to the buffer (its length is known at
+ * compile time, so it isn't calculated).
+ */
+#define APPEND_LITERAL(writer, literal) \
+	appendText(writer, literal, sizeof(literal) - 1)
+
+static const char* facultyName(TechnionFaculty faculty);
+static bool reserveSpace(ReportWriter writer, size_t needed);
+static void appendText(ReportWriter writer, const char* text, size_t length);
+static void appendString(ReportWriter writer, const char* string);
+static void appendInt(ReportWriter writer, int number);
+
+/*
+ * A static function that returns the name of a faculty.
+ */
+static const char* facultyName(TechnionFaculty faculty) {
+	if(((int)faculty < 0) || (faculty >= UNKNOWN))
+		return UNKNOWN_FACULTY_NAME;
+	return faculty_names[faculty];
+}
+
+/*
+ * A static function that makes sure the buffer has room for more characters.
+ * The buffer grows if it's needed, and if it can't grow - the text in it is
+ * flushed.
+ * #return:
+ * 	false - if there's no room for the characters, true - otherwise.
+ */
+static bool reserveSpace(ReportWriter writer, size_t needed) {
+	assert(writer);
+	if(writer->length + needed <= writer->capacity)
+		return true;
+	size_t new_capacity = writer->capacity;
+	while(writer->length + needed > new_capacity)
+		new_capacity *= GROWTH_FACTOR;
+	char* new_buffer = realloc(writer->buffer, new_capacity);
+	if(new_buffer) {
+		writer->buffer = new_buffer;
+		writer->capacity = new_capacity;
+		return true;
+	}
+	CHECK_VALID((reportWriterFlush(writer) == REPORT_WRITER_SUCCESS), false)
+	return (needed <= writer->capacity);
+}
+
+/*
+ * A static function that adds text to the buffer. There must be room for it.
+ */
+static void appendText(ReportWriter writer, const char* text, size_t length) {
+	assert(writer && text && (writer->length + length <= writer->capacity));
+	memcpy(writer->buffer + writer->length, text, length);
+	writer->length += length;
+}
+
+/*
+ * A static function that adds a string to the buffer. There must be room for
+ * it.
+ */
+static void appendString(ReportWriter writer, const char* string) {
+	assert(string);
+	appendText(writer, string, strlen(string));
+}
+
+/*
+ * A static function that adds a number to the buffer, the same way "%d"
+ * prints it. There must be room for MAX_INT_LENGTH characters.
+ */
+static void appendInt(ReportWriter writer, int number) {
+	assert(writer && (writer->length + MAX_INT_LENGTH <= writer->capacity));
+	char digits[MAX_INT_LENGTH];
+	int amount = 0;
+	//The absolute value is calculated as unsigned, so INT_MIN fits too.
+	unsigned int value = (number < 0) ? (0u - (unsigned int)number) :
+	(unsigned int)number;
+	do {
+		digits[amount++] = (char)('0' + (value % 10));
+		value /= 10;
+	} while(value > 0);
+	if(number < 0)
+		writer->buffer[(writer->length)++] = '-';
+	while(amount > 0)
+		writer->buffer[(writer->length)++] = digits[--amount];
+}
+
+ReportWriter reportWriterCreate(FILE* channel) {
+	ReportWriter writer = malloc(sizeof(*writer));
+	CHECK_VALID(writer, NULL)
+	writer->buffer = malloc(INITIAL_CAPACITY);
+	if(!(writer->buffer)) {
+		free(writer);
+		return NULL;
+	}
+	writer->length = 0;
+	writer->capacity = INITIAL_CAPACITY;
+	writer->channel = channel;
+	return writer;
+}
+
+ReportWriterResult reportWriterDestroy(ReportWriter writer) {
+	CHECK_VALID(writer, REPORT_WRITER_NULL_PARAMETER)
+	free(writer->buffer);
+	free(writer);
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterSetChannel(ReportWriter writer,
+FILE* channel) {
+	CHECK_VALID(writer && channel, REPORT_WRITER_NULL_PARAMETER)
+	ReportWriterResult result = reportWriterFlush(writer);
+	CHECK_VALID((result == REPORT_WRITER_SUCCESS), result)
+	writer->channel = channel;
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterDayHeader(ReportWriter writer, int day,
+int events) {
+	CHECK_VALID(writer, REPORT_WRITER_NULL_PARAMETER)
+	CHECK_VALID(reserveSpace(writer, 2*MAX_INT_LENGTH + 32),
+	REPORT_WRITER_OUT_OF_MEMORY)
+	APPEND_LITERAL(writer, "Day #");
+	appendInt(writer, day);
+	APPEND_LITERAL(writer, ": ");
+	appendInt(writer, events);
+	APPEND_LITERAL(writer, " events in total\n");
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterOrder(ReportWriter writer, char* email,
+int skill, TechnionFaculty client_faculty, char* company_email,
+TechnionFaculty room_faculty, int id, int hour, int difficulty, int num_ppl,
+int total_price) {
+	CHECK_VALID(writer && email && company_email,
+	REPORT_WRITER_NULL_PARAMETER)
+	CHECK_VALID(reserveSpace(writer, strlen(email) + strlen(company_email) +
+	2*MAX_FACULTY_LENGTH + 6*MAX_INT_LENGTH + 256), REPORT_WRITER_OUT_OF_MEMORY)
+	APPEND_LITERAL(writer, "The order was made by ");
+	appendString(writer, email);
+	APPEND_LITERAL(writer, ", from the faculty of ");
+	appendString(writer, facultyName(client_faculty));
+	APPEND_LITERAL(writer, ", who is skilled at ");
+	appendInt(writer, skill);
+	APPEND_LITERAL(writer, "\n\tIt was made for room ");
+	appendInt(writer, id);
+	APPEND_LITERAL(writer, ", of ");
+	appendString(writer, company_email);
+	APPEND_LITERAL(writer, " from ");
+	appendString(writer, facultyName(room_faculty));
+	APPEND_LITERAL(writer, ", for the time ");
+	appendInt(writer, hour);
+	APPEND_LITERAL(writer, ":00\n\tThe room is best for a skill level of ");
+	appendInt(writer, difficulty);
+	APPEND_LITERAL(writer, ". ");
+	appendInt(writer, num_ppl);
+	APPEND_LITERAL(writer, " people came for the total price of ");
+	appendInt(writer, total_price);
+	APPEND_LITERAL(writer, "\n");
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterDayFooter(ReportWriter writer, int day) {
+	CHECK_VALID(writer, REPORT_WRITER_NULL_PARAMETER)
+	CHECK_VALID(reserveSpace(writer, MAX_INT_LENGTH + 32),
+	REPORT_WRITER_OUT_OF_MEMORY)
+	APPEND_LITERAL(writer, "That is all for day #");
+	appendInt(writer, day);
+	APPEND_LITERAL(writer, "!\n\n");
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterFlush(ReportWriter writer) {
+	CHECK_VALID(writer && writer->channel, REPORT_WRITER_NULL_PARAMETER)
+	CHECK_VALID((fflush(writer->channel) == 0), REPORT_WRITER_WRITE_FAILED)
+	int fd = fileno(writer->channel);
+	size_t written = 0;
+	while(written < writer->length) {
+		ssize_t result = write(fd, writer->buffer + written,
+		writer->length - written);
+		if((result < 0) && (errno == EINTR))
+			continue;
+		if(result <= 0) {
+			writer->length = 0;
+			return REPORT_WRITER_WRITE_FAILED;
+		}
+		written += (size_t)result;
+	}
+	writer->length = 0;
+	return REPORT_WRITER_SUCCESS;
+}
+
+ReportWriterResult reportWriterAppend(ReportWriter writer, ReportWriter other) {
+	CHECK_VALID(writer && other, REPORT_WRITER_NULL_PARAMETER)
+	bool has_room = reserveSpace(writer, other->length);
+	if(has_room)
+		appendText(writer, other->buffer, other->length);
+	other->length = 0;
+	return has_room ? REPORT_WRITER_SUCCESS : REPORT_WRITER_OUT_OF_MEMORY;
+}
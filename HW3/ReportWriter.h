@@ -0,0 +1,120 @@
+#ifndef REPORTWRITER_H_
+#define REPORTWRITER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "mtm_ex3.h"
+
+typedef struct ReportWriter_t *ReportWriter; //Name of the ADT.
+
+typedef enum {
+	//The report writer's errors:
+	REPORT_WRITER_SUCCESS,
+	REPORT_WRITER_NULL_PARAMETER,
+	REPORT_WRITER_OUT_OF_MEMORY,
+	REPORT_WRITER_WRITE_FAILED,
+} ReportWriterResult;
+
+/*
+ * Allocates a new report writer.
+ * The writer builds the text of a day's report in one buffer, instead of
+ * printing every line with its own formatted write, and sends the whole buffer
+ * to its output channel with one write when it's flushed. The text is exactly
+ * the text the mtm_ex3.h printers of the same parts print. The buffer is kept
+ * (and only grows) from one report to the next.
+ * 	$channel: The output channel the reports are written to. Can be sent as
+ * 	NULL for a writer that only builds part of a report, which is then added
+ * 	to another writer with reportWriterAppend (such a writer is never
+ * 	flushed).
+ * #return:
+ * 	NULL if an allocation has failed,
+ * 	and a new report writer otherwise.
+ */
+ReportWriter reportWriterCreate(FILE* channel);
+
+/*
+ * Deallocates a report writer. Text that wasn't flushed is discarded, and the
+ * output channel isn't closed.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterDestroy(ReportWriter writer);
+
+/*
+ * Modifies the writer's output channel. The text that was written so far is
+ * flushed to the previous channel first.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	REPORT_WRITER_WRITE_FAILED - If flushing the previous channel has failed,
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterSetChannel(ReportWriter writer, FILE* channel);
+
+/*
+ * Adds the header of a day's report (the text mtmPrintDayHeader prints).
+ * If the buffer can't grow, the text that was written so far is flushed to
+ * make room for it.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	REPORT_WRITER_OUT_OF_MEMORY - If there's no room for the text,
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterDayHeader(ReportWriter writer, int day,
+int events);
+
+/*
+ * Adds the description of an order (the text mtmPrintOrder prints).
+ * If the buffer can't grow, the text that was written so far is flushed to
+ * make room for it.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	REPORT_WRITER_OUT_OF_MEMORY - If there's no room for the text,
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterOrder(ReportWriter writer, char* email,
+int skill, TechnionFaculty client_faculty, char* company_email,
+TechnionFaculty room_faculty, int id, int hour, int difficulty, int num_ppl,
+int total_price);
+
+/*
+ * Adds the footer of a day's report (the text mtmPrintDayFooter prints).
+ * If the buffer can't grow, the text that was written so far is flushed to
+ * make room for it.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	REPORT_WRITER_OUT_OF_MEMORY - If there's no room for the text,
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterDayFooter(ReportWriter writer, int day);
+
+/*
+ * Writes all the text in the buffer to the output channel with one write (or
+ * more, if the channel takes only part of it at a time), and empties the
+ * buffer. Whatever the channel's own buffer holds is flushed before, so the
+ * text comes out in the order it was printed.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent (or the writer
+ * 	has no channel),
+ * 	REPORT_WRITER_WRITE_FAILED - If writing to the channel has failed,
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterFlush(ReportWriter writer);
+
+/*
+ * Adds all the text of another writer after the writer's text, and empties
+ * the other writer.
+ * If the buffer can't grow, the text that was written so far is flushed to
+ * make room for it.
+ * #return:
+ * 	REPORT_WRITER_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	REPORT_WRITER_OUT_OF_MEMORY - If there's no room for the text (the other
+ * 	writer's text is discarded),
+ * 	REPORT_WRITER_SUCCESS - Otherwise.
+ */
+ReportWriterResult reportWriterAppend(ReportWriter writer, ReportWriter other);
+
+#endif /* REPORTWRITER_H_ */
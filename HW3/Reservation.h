@@ -5,7 +5,9 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <limits.h>
 #include "mtm_ex3.h"
+#include "Pool.h"
 
 typedef struct Reservation_t *Reservation; //Name of the ADT.
 
@@ -20,6 +22,10 @@ typedef enum {
 //The return value of the integer getter functions
 #define RESERVATION_ILLEGAL -1
 
+//The last day a reservation can be for: the absolute time of its last hour
+//(23, in a day of 24 hours) still fits in an int.
+#define RESERVATION_LAST_DAY ((INT_MAX - 23) / 24)
+
 //We demand that the entry fee of a room id divisible by MULTIPLE
 #define MULTIPLE 4
 
@@ -30,11 +36,16 @@ typedef enum {
 /*
  * Allocates a new reservation.
  * Creates a new reservation and initializes its fields according to the
- * parameters given. The required fields are:
+ * parameters given. The reservation keeps its scheduled time as an absolute
+ * time: days are counted from the system's first day (day 0), so the
+ * reservation doesn't need to be updated when days pass.
+ * The required fields are:
  *  $result: Holds the result of the create function. Can be sent as NULL if
  *  the result of this function is not needed.
- * 	$email: Pointer to the email string of the customer who made this
- * 	reservation. Must contain '@'.
+ * 	$pool: The pool the reservation is taken from (and given back to when it's
+ * 	destroyed). Can be sent as NULL to allocate the reservation by itself.
+ * 	$escaper_id: The id of the email of the customer who made this reservation
+ * 	(in the system's email index). Must be non-negative.
  * 	$id: Id of the desired room for this reservation. Must be greater than 0.
  * 	$faculty: The faculty to which the customer belongs.
  * 	$room_price: The original entry fee of the room.
@@ -42,12 +53,11 @@ typedef enum {
  * 	$room_close: The time when the room closes.
  * 	$num_of_people: The amount of people for this reservation. Must be greater
  * 	than 0.
- * 	$date: The scheduled time for the reservation. The time is a string of the
- * 	format: "dd-hh", where the first two digits represent how many days from now
- * 	the reservation is for, and the the last two digits represent the hour of
- * 	the day for the reservation. Days must be non-negative, hour is between 0
- * 	and 23, but has to be during the time when the escape room is open: more or
- * 	equal to the open time, and less than the close time.
+ * 	$day: The day of the reservation, counted from the system's first day.
+ * 	Must be non-negative, and no later than RESERVATION_LAST_DAY.
+ * 	$hour: The hour of the reservation. Has to be during the time when the
+ * 	escape room is open: more or equal to the open time, and less than the
+ * 	close time.
  * 	$has_discount: a flag that represents whether or not the escaper deserves
  * 	a discount for this reservation. The escaper gets a discount iff he's a
  * 	member of the same faculty to which this room belongs.
@@ -55,12 +65,18 @@ typedef enum {
  * 	NULL if one of the parameters is invalid or an allocation fails,
  * 	and a new reservation otherwise.
  */
-Reservation reservationCreate(ReservationResult *result, char* email, int id,
-TechnionFaculty faculty, int room_price, int room_open, int room_close,
-int num_of_people, char* date, bool has_discount);
+Reservation reservationCreate(ReservationResult *result, Pool pool,
+int escaper_id, int id, TechnionFaculty faculty, int room_price, int room_open,
+int room_close, int num_of_people, int day, int hour, bool has_discount);
 
 /*
- * Deallocates a reservation.
+ * Returns the size of a reservation, for creating a pool of reservations.
+ */
+size_t reservationSize();
+
+/*
+ * Deallocates a reservation. A reservation that was taken from a pool is given
+ * back to it.
  * #return:
  * 	RESERVATION_NULL_PARAMETER - if a NULL pointer was sent.
  * 	RESERVATION_SUCCESS - otherwise.
@@ -69,7 +85,8 @@ ReservationResult reservationDestroy(Reservation reservation);
 
 /*
  * Creates a copy of the target reservation.
- * The new copy will contain all of the values of the source reservation.
+ * The new copy will contain all of the values of the source reservation. It
+ * isn't taken from the source's pool.
  * #return:
  * 	NULL if a NULL pointer was sent or a memory allocation failed,
  * 	and a new copy of the reservation otherwise.
@@ -77,29 +94,23 @@ ReservationResult reservationDestroy(Reservation reservation);
 Reservation reservationCopy(Reservation reservation);
 
 /*
- * Decreases the reservation's scheduled day by one.
- * #Return:
- * 	RESERVATION_NULL_PARAMETER - if a NULL pointer was sent.
- * 	RESERVATION_SUCCESS - otherwise.
- */
-ReservationResult reservationNextDay(Reservation reservation);
-
-/*
- * Checks if a reservation is scheduled for today, that is: its got 0 days left.
+ * Checks if a reservation is scheduled for a given day.
+ * 	$today: The day (counted from the system's first day).
  * #return:
  * 	false - if a NULL pointer was sent, or if the reservation is not for today.
  * 	true - otherwise.
  */
-bool reservationIsToday(Reservation reservation);
+bool reservationIsToday(Reservation reservation, int today);
 
 /*
- * Returns the total amount of hours left for the reservation.
+ * Returns the absolute time of the reservation: the amount of hours from the
+ * start of the system's first day to the reservation.
  * Note: a day is composed of 24 hours.
  * #return:
- * 	RESERVATION_NULL_PARAMETER - if a NULL pointer was sent,
- * 	and the total amount of hours left for the reservation otherwise.
+ * 	RESERVATION_ILLEGAL - if a NULL pointer was sent,
+ * 	and the absolute time of the reservation otherwise.
  */
-int reservationHoursLeft(Reservation reservation);
+int reservationGetTime(Reservation reservation);
 
 /*
  * Returns the reservation's scheduled hour.
@@ -110,9 +121,10 @@ int reservationHoursLeft(Reservation reservation);
 int reservationGetHour(Reservation reservation);
 
 /*
- * Returns the reservation's scheduled day.
+ * Returns the reservation's scheduled day (counted from the system's first
+ * day).
  * #return:
- * 	RESERVASION_NULL_PARAMETER - if a NULL pointer was sent,
+ * 	RESERVATION_ILLEGAL - if a NULL pointer was sent,
  * 	and the scheduled day of the reservation otherwise.
  */
 int reservationGetDay(Reservation reservation);
@@ -143,14 +155,31 @@ int reservationGetPeople(Reservation reservation);
 ReservationResult reservationGetRoomId(Reservation reservation, int* id);
 
 /*
- * Returns the email of the escaper to whom this reservation belongs to
- * (in a parameter address!).
+ * Returns the faculty of the room for which this reservation was made.
+ * #return:
+ * 	UNKNOWN - if a NULL pointer was sent,
+ * 	and the faculty of the reserved room otherwise.
+ */
+TechnionFaculty reservationGetFaculty(Reservation reservation);
+
+/*
+ * Returns the id of the email of the escaper to whom this reservation belongs.
+ * #return:
+ * 	RESERVATION_ILLEGAL - if a NULL pointer was sent,
+ * 	and the escaper's id otherwise.
+ */
+int reservationGetEscaperId(Reservation reservation);
+
+/*
+ * Sets the id of the email of the escaper to whom this reservation belongs.
+ * 	$escaper_id: The id of the escaper's email. Must be non-negative.
  * #return:
  * 	RESERVATION_NULL_PARAMETER - if a NULL pointer was sent.
+ * 	RESERVATION_INVALID_PARAMETER - if the id is negative.
  * 	RESERVATION_SUCCESS - otherwise.
  */
-ReservationResult reservationGetEscaperEmail(Reservation reservation,
-char** email);
+ReservationResult reservationSetEscaperId(Reservation reservation,
+int escaper_id);
 
 /*
  * Returns whether or not the reservation is discounted off its' original price
@@ -13,14 +13,10 @@ struct Room_t {
 	int difficulty; //The room's difficulty.
 	int total_money_earned; //The room's total earns from customers.
 	List room_reservations; //A list of reservations for this room.
+	Occupancy occupancy; //The reserved hours of every day that's reserved.
+	int reservations_amount; //The amount of reservations in the list.
 };
 
-//In our format, hours are represented as two digits.
-#define HR_DIGITS 2
-
-//In our format, days and hours are separated with a dash sign.
-#define SEPARATE_FIELDS '-'
-
 //Total amount of hours in one day.
 #define HOURS_IN_A_DAY 24
 
@@ -44,43 +40,35 @@ struct Room_t {
  */
 #define POWER_OF_2(x) ((x)*(x))
 
-static int exponent10(int num, int p);
+/*
+ * A macro for the mask of the hours from a certain hour on (bit h is on iff
+ * h >= hour). The hour is at most HOURS_IN_A_DAY, so the shift is defined, and
+ * the bits after the day's last hour are on too: a room that closes at the
+ * end of the day isn't open in them.
+ */
+#define HOURS_FROM(hour) (~0u << (hour))
+
 static ListElement copyReservation(ListElement res);
 static void freeReservation(ListElement res);
 static bool checkParameters(int id, int entry_fee, int recommended_people,
-int difficulty, char* working_hours, int *open, int *close);
-static bool checkHours(char *working_hours, int *time);
-static void roomExecuteReservations(Room room);
-static void tryNextHour(Room room, int* hours_left, int* days, int* hour);
-
+int difficulty, int open, int close);
+static int roomExecuteReservations(Room room, int today);
+static void roomReleaseCurrent(Room room, Reservation reservation);
+static int lowestBit(unsigned int mask);
+static int countBits(unsigned int mask);
 
-/*
- * A static function for raising a 10 to a power, and then multiplying that by
- * a given number.
- * 	$num: The coefficient number.
- * 	$p: The power to which 10 should be raised.
- * #return:
- * 	The number multiplied by 10 to the power of p: num*10^(p).
- */
-static int exponent10(int num, int p) {
-	if(num==0)
-		return 0;
-	int result = num;
-	for(int i=0; i<p; i++)
-		result*=10;
-	return result;
-}
 
 /*
  * A static function that defines the room's list's copy function.
  * The copy function is required to get an element of type ListElement, and
  * return an element of the same type.
- * The copy function is defined as follows: the list's elements are of the type
- * "Reservation", so we cast the element to be its real type, and then we return
- * the value we get from Reservation's copy function
+ * The list takes ownership of the reservations that are inserted to it, so the
+ * copy function returns the element as is. That way, a reservation that's in
+ * the room stays at the same address, and other parts of the system can point
+ * to it.
  */
 static ListElement copyReservation(ListElement res) {
-	return reservationCopy((Reservation)(res));
+	return res;
 }
 
 /*
@@ -102,97 +90,85 @@ static void freeReservation(ListElement res) {
  * 	$The room's entry fee: a positive number. Must be a multiple of 4.
  * 	$The amount of people recommended for the room: a positive number.
  * 	$The room's difficulty: a number between 1 and 10 (included).
- * 	$The room's scheduled working hours: received as a string of the following
- * 	format: "xx-yy". xx and yy must be between 0 and 24, where yy>xx.
- * 	$open: the address of an integer that will store the room's open time.
- * 	$close: the address of an integer that will store the room's close time.
+ * 	$open: The hour when the room opens: between 0 and 23.
+ * 	$close: The hour when the room closes: after the open hour, and at most 24.
  *	#return:
  *	 false - if any of the parameters does not meet the listed requirements.
  *	 true - otherwise.
  */
 static bool checkParameters(int id, int entry_fee, int recommended_people,
-int difficulty, char* working_hours, int *open, int *close) {
-	assert(open && close);
-	CHECK_VALID((working_hours), false)
+int difficulty, int open, int close) {
 	CHECK_VALID((id > 0), false)
 	CHECK_VALID(((entry_fee>=0) && (entry_fee%MULTIPLE == 0)), false)
 	CHECK_VALID((recommended_people > 0), false)
 	CHECK_VALID(((difficulty>=1) && (difficulty<=10)), false)
-	CHECK_VALID((strlen(working_hours) == (2*HR_DIGITS + 1)), false)
-	CHECK_VALID((working_hours[HR_DIGITS] == SEPARATE_FIELDS), false)
-	CHECK_VALID((checkHours(working_hours, open)), false)
-	CHECK_VALID((checkHours((working_hours+HR_DIGITS+1), close)), false)
-	CHECK_VALID((*open >= 0 && *close > *open && *close <= HOURS_IN_A_DAY),
-	false)
-	CHECK_VALID(((*close) > (*open)), false)
+	CHECK_VALID((open >= 0 && close > open && close <= HOURS_IN_A_DAY), false)
 	//All of the room's parameters are valid!
 	return true;
 }
 
-/*
- * A static function used in order to check the validity of an hour in the
- * time period string parameter.
- * A legal hour is composed of a letter that belongs to {0,1,2} followed up by
- * a letter that belongs to {0,1,2,3}.
- * 	$working_hours: the time period string.
- * 	$time: address of the value that will store the hour as a number
- * #return:
- * 	false - if the translated hour is illegal (wrong format / values),
- * 	true - otherwise
- */
-static bool checkHours(char *working_hours, int *time) {
-	int temp_digit = 0;
-	(*time) = 0;
-	for(int i = 0; i<HR_DIGITS; i++) {
-		temp_digit = (int)((*(working_hours+i)) - '0');
-		if(temp_digit<0 || temp_digit>9) return false;
-		(*time)+= exponent10(temp_digit, (HR_DIGITS-1-i));
-	}
-	return true;
-}
-
 /*
  * Executes today's reservations: Adds the reservation's price to the room's
- * total money earned, and then deletes them from the room.
+ * total money earned, and then deletes them from the room. The reservations
+ * are sorted by time, so today's reservations are at the start of the list.
+ * Returns the money that was earned from the executed reservations.
  */
-void roomExecuteReservations(Room room) {
+static int roomExecuteReservations(Room room, int today) {
 	assert(room);
+	int earns = 0;
 	Reservation res = (Reservation)listGetFirst(room->room_reservations);
-	while((res) && reservationIsToday(res)) {
-		(room->total_money_earned)+=reservationGetPrice(res);
-		listRemoveCurrent(room->room_reservations);
+	while((res) && (reservationGetDay(res) <= today)) {
+		earns+=reservationGetPrice(res);
+		roomReleaseCurrent(room, res);
 		res = (Reservation)listGetFirst(room->room_reservations);
 	}
+	(room->total_money_earned)+=earns;
+	return earns;
 }
 
 /*
- * Gets 3 pointers. hours_left contains the amount of hours left of a
- * reservation, and we assign the days and hour to point at the new best
- * days-hour combination when the room is open (of course, if we increase the
- * hour to beyond the room's close time - we have to go to the next day!)
+ * Removes the current reservation of the room's list (the given reservation),
+ * and frees its hour in the room's occupancy.
  */
-static void tryNextHour(Room room, int* hours_left, int* days, int* hour) {
-	assert(hours_left && days && hour);
-	int req_days = (*hours_left) / HOURS_IN_A_DAY,
-	req_hour = ((*hours_left) % HOURS_IN_A_DAY) + 1;
-	if(room->schedule_close <= req_hour) {
-		req_days++;
-		req_hour = room->schedule_open;
-	}
-	(*hours_left) = HOURS_IN_A_DAY * req_days + req_hour;
-	(*days) = req_days;
-	(*hour) = req_hour;
+static void roomReleaseCurrent(Room room, Reservation reservation) {
+	assert(room && reservation);
+	occupancyRelease(room->occupancy, reservationGetDay(reservation),
+	reservationGetHour(reservation));
+	listRemoveCurrent(room->room_reservations);
+	(room->reservations_amount)--;
+}
+
+/*
+ * Returns the index of the lowest bit that's on in a mask (the amount of
+ * trailing zeros). The mask must not be 0.
+ * The lowest bit is isolated (mask & -mask), and a de Bruijn sequence maps
+ * each of the 32 possible results to a different index of the table.
+ */
+static int lowestBit(unsigned int mask) {
+	static const int debruijn_index[32] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+	assert(mask);
+	return debruijn_index[(((mask & (~mask + 1)) * 0x077CB531u) & 0xFFFFFFFFu)
+	>> 27];
+}
+
+/*
+ * Returns the amount of bits that are on in a mask. The bits are summed in
+ * pairs, then in groups of 4 and then the bytes are summed by a multiplication.
+ */
+static int countBits(unsigned int mask) {
+	mask = mask - ((mask >> 1) & 0x55555555u);
+	mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+	mask = (mask + (mask >> 4)) & 0x0F0F0F0Fu;
+	return (int)(((mask * 0x01010101u) & 0xFFFFFFFFu) >> 24);
 }
 
 Room roomCreate(RoomResult* result, int id, int entry_fee,
-int recommended_people, int difficulty, char* working_hours) {
-	int open_time = 0, close_time = 0;
-	if(!working_hours) {
-		INIT_IF_EXISTS(result, ROOM_NULL_PARAMETER);
-		return NULL;
-	}
+int recommended_people, int difficulty, int open_time, int close_time) {
 	if(!checkParameters(id, entry_fee, recommended_people, difficulty,
-	working_hours, &open_time, &close_time)) {
+	open_time, close_time)) {
 		INIT_IF_EXISTS(result, ROOM_INVALID_PARAMETER);
 		return NULL;
 	}
@@ -203,7 +179,10 @@ int recommended_people, int difficulty, char* working_hours) {
 		return NULL;
 	}
 	room->room_reservations = listCreate(copyReservation, freeReservation);
-	if(!(room->room_reservations)) {
+	room->occupancy = occupancyCreate();
+	if(!(room->room_reservations) || !(room->occupancy)) {
+		listDestroy(room->room_reservations);
+		occupancyDestroy(room->occupancy);
 		free(room);
 		INIT_IF_EXISTS(result, ROOM_OUT_OF_MEMORY);
 		return NULL;
@@ -216,6 +195,7 @@ int recommended_people, int difficulty, char* working_hours) {
 	room->schedule_open = open_time;
 	room->schedule_close = close_time;
 	room->total_money_earned = 0;
+	room->reservations_amount = 0;
 	INIT_IF_EXISTS(result, ROOM_SUCCESS);
 	return room;
 }
@@ -223,28 +203,33 @@ int recommended_people, int difficulty, char* working_hours) {
 RoomResult roomDestroy(Room room) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
 	listDestroy(room->room_reservations);
+	occupancyDestroy(room->occupancy);
 	free(room);
 	return ROOM_SUCCESS;
 }
 
 Room roomCopy(Room room) {
 	CHECK_VALID(room, NULL)
-	char hours[HR_DIGITS*2 + 2] = {0};
-	for(int i=0; i<HR_DIGITS*2+1; i++)
-		hours[i] = '0';
-	hours[HR_DIGITS] = '-';
-	hours[HR_DIGITS*2] = '1';
 	Room room_copy = roomCreate(NULL, room->id, room->entry_fee,
-	room->recommended_people, room->difficulty, hours);
+	room->recommended_people, room->difficulty, room->schedule_open,
+	room->schedule_close);
 	CHECK_VALID(room_copy, NULL)
-	listDestroy(room_copy->room_reservations);
-	room_copy->room_reservations = listCopy(room->room_reservations);
-	if(!(room_copy->room_reservations)) {
-		free(room_copy);
-		return NULL;
+	//The list owns its elements, so we copy the reservations one by one.
+	LIST_FOREACH(Reservation, reservation, room->room_reservations) {
+		Reservation reservation_copy = reservationCopy(reservation);
+		if((!reservation_copy) || (listInsertLast(room_copy->room_reservations,
+		reservation_copy) != LIST_SUCCESS)) {
+			reservationDestroy(reservation_copy);
+			roomDestroy(room_copy);
+			return NULL;
+		}
+		(room_copy->reservations_amount)++;
+		if(occupancyReserve(room_copy->occupancy, reservationGetDay(reservation),
+		reservationGetHour(reservation)) != OCCUPANCY_SUCCESS) {
+			roomDestroy(room_copy);
+			return NULL;
+		}
 	}
-	room_copy->schedule_open = room->schedule_open;
-	room_copy->schedule_close = room->schedule_close;
 	room_copy->total_money_earned = room->total_money_earned;
 	return room_copy;
 }
@@ -283,6 +268,13 @@ RoomResult roomGetDifficulty(Room room, int *difficulty) {
 	return ROOM_SUCCESS;
 }
 
+RoomResult roomGetRecommendedPeople(Room room, int *recommended_people) {
+	CHECK_VALID(room, ROOM_NULL_PARAMETER)
+	CHECK_VALID(recommended_people, ROOM_NULL_PARAMETER)
+	*recommended_people = room->recommended_people;
+	return ROOM_SUCCESS;
+}
+
 RoomResult roomEarns(Room room, int* money) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
 	CHECK_VALID(money, ROOM_NULL_PARAMETER)
@@ -290,30 +282,43 @@ RoomResult roomEarns(Room room, int* money) {
 	return ROOM_SUCCESS;
 }
 
-bool roomHasReservations(Room room) {
+RoomResult roomSetEarns(Room room, int money) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
-	return (listGetSize(room->room_reservations) > 0);
+	CHECK_VALID((money >= 0), ROOM_INVALID_PARAMETER)
+	room->total_money_earned = money;
+	return ROOM_SUCCESS;
+}
+
+bool roomHasReservations(Room room) {
+	CHECK_VALID(room, false)
+	return (room->reservations_amount > 0);
+}
+
+int roomReservationsAmount(Room room) {
+	CHECK_VALID(room, 0)
+	return room->reservations_amount;
 }
 
-int roomTodaysReservations(Room room) {
+int roomTodaysReservations(Room room, int today) {
 	CHECK_VALID(room, 0)
-	int reservations_amount = 0;
-	LIST_FOREACH(Reservation, reservation, room->room_reservations)
-		if(reservationIsToday(reservation))
-			reservations_amount++;
-	return reservations_amount;
+	//Every reservation of the day has its own bit in the day's mask.
+	return countBits(occupancyGetDay(room->occupancy, today));
 }
 
 RoomResult roomNewReservation(Room room, Reservation reservation) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
 	CHECK_VALID(reservation, ROOM_NULL_PARAMETER)
-	int res_hours = reservationHoursLeft(reservation), curr_hours = 0;
+	int res_hours = reservationGetTime(reservation);
+	//A single bit tells us whether the room is taken at that time.
+	OccupancyResult occupancy_result = occupancyReserve(room->occupancy,
+	reservationGetDay(reservation), reservationGetHour(reservation));
+	if(occupancy_result != OCCUPANCY_SUCCESS)
+		return (occupancy_result == OCCUPANCY_OUT_OF_MEMORY) ?
+		(ROOM_OUT_OF_MEMORY) : (ROOM_ALREADY_RESERVED);
 	Reservation current = (Reservation)listGetFirst(room->room_reservations);
 	while(current) {
 		//We find the correct segment in the list to insert the reservation.
-		curr_hours = reservationHoursLeft(current);
-		if(res_hours == curr_hours) return ROOM_ALREADY_RESERVED;
-		else if(res_hours < curr_hours) break;
+		if(res_hours < reservationGetTime(current)) break;
 		current = (Reservation)listGetNext(room->room_reservations);
 	}
 	ListResult res;
@@ -324,58 +329,73 @@ RoomResult roomNewReservation(Room room, Reservation reservation) {
 	else
 		//The given reservation is for the latest date of all the reservations.
 		res = listInsertLast(room->room_reservations, reservation);
-	if(res!=LIST_SUCCESS) return ROOM_OUT_OF_MEMORY;
+	if(res!=LIST_SUCCESS) {
+		occupancyRelease(room->occupancy, reservationGetDay(reservation),
+		reservationGetHour(reservation));
+		return ROOM_OUT_OF_MEMORY;
+	}
+	(room->reservations_amount)++;
 	return ROOM_SUCCESS;
 }
 
-RoomResult roomRemoveEscaperReservations(Room room, char* email) {
+RoomResult roomRemoveReservation(Room room, int time) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
-	CHECK_VALID(email, ROOM_NULL_PARAMETER)
-	char* current_email = NULL;
-	Reservation curr_reservation = listGetFirst(room->room_reservations);
-	while(curr_reservation) {
-		reservationGetEscaperEmail(curr_reservation, &email);
-		if(strcmp(email, current_email) == 0) {
-			listRemoveCurrent(room->room_reservations);
-			curr_reservation = listGetFirst(room->room_reservations);
-		}
-		else
-			curr_reservation = listGetNext(room->room_reservations);
-	}
+	Reservation reservation = roomGetReservationInTime(room, time);
+	CHECK_VALID(reservation, ROOM_INVALID_PARAMETER)
+	//The list's iterator points at the reservation we've just found.
+	roomReleaseCurrent(room, reservation);
 	return ROOM_SUCCESS;
 }
 
-Reservation roomGetReservationInTime(Room room, int hours_left) {
+Reservation roomGetReservationInTime(Room room, int time) {
 	CHECK_VALID(room, NULL)
-	int curr_hours = 0;
+	CHECK_VALID((time >= 0), NULL)
+	//Most hours aren't reserved, and a single bit tells us that.
+	CHECK_VALID(occupancyIsReserved(room->occupancy, time / HOURS_IN_A_DAY,
+	time % HOURS_IN_A_DAY), NULL)
+	int curr_time = 0;
 	LIST_FOREACH(Reservation, curr_reservation, room->room_reservations) {
-		curr_hours = reservationHoursLeft(curr_reservation);
-		if(curr_hours > hours_left)
+		curr_time = reservationGetTime(curr_reservation);
+		if(curr_time > time)
 			break;
-		else if (curr_hours == hours_left)
+		else if (curr_time == time)
 			return curr_reservation;
 	}
 	return NULL;
 }
 
-RoomResult roomGetEarliestTimeAvailable(Room room, int* days, int* hour) {
+RoomResult roomGetEarliestTimeAvailable(Room room, Occupancy busy, int* days,
+int* hour) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
 	CHECK_VALID(days, ROOM_NULL_PARAMETER)
 	CHECK_VALID(hour, ROOM_NULL_PARAMETER)
-	int hours_left = HOURS_IN_A_DAY*(*days) + (*hour);
-	while(((*hour) >= room->schedule_close) || ((*hour) < room->schedule_open)
-	|| (roomGetReservationInTime(room, hours_left) != NULL))
-		tryNextHour(room, &hours_left, days, hour);
-	return ROOM_SUCCESS;
+	//The hours when the room is open, as a mask: bits [open, close).
+	unsigned int open_hours = HOURS_FROM(room->schedule_open) &
+	~HOURS_FROM(room->schedule_close);
+	unsigned int from_hour = HOURS_FROM(*hour);
+	int day = (*days);
+	while(true) {
+		//A NULL map has no reserved hours, so it doesn't change the mask.
+		unsigned int free_hours = open_hours & from_hour &
+		~occupancyGetDay(room->occupancy, day) & ~occupancyGetDay(busy, day);
+		if(free_hours) {
+			//The earliest free hour of the day is its lowest bit.
+			(*days) = day;
+			(*hour) = lowestBit(free_hours);
+			return ROOM_SUCCESS;
+		}
+		//The day is full (from the given hour). We try the next one, from its
+		//first hour. There are finitely many reserved days (in both maps), so
+		//we'll stop.
+		day++;
+		from_hour = HOURS_FROM(0);
+	}
 }
 
-RoomResult roomNextDay(Room room) {
+RoomResult roomNextDay(Room room, int today, int* earns) {
 	CHECK_VALID(room, ROOM_NULL_PARAMETER)
-	roomExecuteReservations(room);
-	LIST_FOREACH(Reservation, res, room->room_reservations) {
-		assert(res);
-		reservationNextDay(res);
-	}
+	int today_earns = roomExecuteReservations(room, today);
+	INIT_IF_EXISTS(earns, today_earns);
 	return ROOM_SUCCESS;
 }
 
@@ -385,3 +405,13 @@ int roomCalculatedScore(Room room, int escaper_skill, int participants) {
 	return (POWER_OF_2(room->recommended_people - participants) +
 	POWER_OF_2(room->difficulty - escaper_skill));
 }
+
+Reservation roomFirstReservation(Room room) {
+	CHECK_VALID(room, NULL)
+	return (Reservation)listGetFirst(room->room_reservations);
+}
+
+Reservation roomNextReservation(Room room) {
+	CHECK_VALID(room, NULL)
+	return (Reservation)listGetNext(room->room_reservations);
+}
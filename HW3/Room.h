@@ -7,6 +7,7 @@
 #include <assert.h>
 #include "list.h"
 #include "Reservation.h"
+#include "Occupancy.h"
 
 typedef struct Room_t *Room; //Name of the ADT.
 
@@ -34,15 +35,15 @@ typedef enum {
  * 	$recommended_people: The amount of people recommended for the room. Must be
  * 	a positive number.
  * 	$difficulty: The room's difficulty. Must be between 1 and 10 (included).
- * 	$working_hours: The room's scheduled working hours. Received as a string of
- * 	the following format: "xx-yy". xx and yy must be between 0 and 23,
- * 	where yy>xx.
+ * 	$open_time: The hour when the room opens. Must be between 0 and 23.
+ * 	$close_time: The hour when the room closes. Must be after the open time,
+ * 	and at most 24.
  * #return:
  * 	NULL if one of the parameters is invalid or an allocation fails,
  * 	and a new room otherwise. The new room has no reservations nor earns.
  */
 Room roomCreate(RoomResult* result, int id, int entry_fee,
-int recommended_people, int difficulty, char* working_hours);
+int recommended_people, int difficulty, int open_time, int close_time);
 
 /*
  * Deallocates a room. Clears all of the reservations of the room by using the
@@ -54,7 +55,7 @@ int recommended_people, int difficulty, char* working_hours);
 RoomResult roomDestroy(Room room);
 
 /*
- * Creates a copy of the target room.
+ * Creates a copy of the target room. The room's reservations are copied too.
  * The new copy will contain all of the values of the source room's fields.
  * #return:
  * 	NULL if a NULL pointer was sent or a memory allocation failed,
@@ -107,6 +108,15 @@ RoomResult roomGetCloseTime(Room room, int *time);
  */
 RoomResult roomGetDifficulty(Room room, int *difficulty);
 
+/*
+ * Gets the amount of people recommended to participate in the room.
+ * 	$recommended_people: address of a value that will store the amount.
+ * #return:
+ * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
+ * 	ROOM_SUCCESS - otherwise.
+ */
+RoomResult roomGetRecommendedPeople(Room room, int *recommended_people);
+
 /*
  * Gets the total amount of money earned in the room.
  * 	$money: address of a value that will store the amount of money.
@@ -116,6 +126,17 @@ RoomResult roomGetDifficulty(Room room, int *difficulty);
  */
 RoomResult roomEarns(Room room, int* money);
 
+/*
+ * Sets the total amount of money earned in the room (used when a room is
+ * restored from a checkpoint).
+ * 	$money: The amount of money. Must be non-negative.
+ * #return:
+ * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
+ * 	ROOM_INVALID_PARAMETER - if the amount is negative.
+ * 	ROOM_SUCCESS - otherwise.
+ */
+RoomResult roomSetEarns(Room room, int money);
+
 /*
  * Checks if a room has any scheduled reservations at the time.
  * #return:
@@ -124,22 +145,33 @@ RoomResult roomEarns(Room room, int* money);
  */
 bool roomHasReservations(Room room);
 
+/*
+ * Returns the amount of reservations that are scheduled for this room.
+ * #return:
+ *  0: if a NULL parameter was sent or the room has no reservations,
+ *  and the amount of the room's reservations otherwise.
+ */
+int roomReservationsAmount(Room room);
+
 /*
  * Returns how many reservations are scheduled for today for this room.
+ * 	$today: The system's current day.
  * #return:
  *  0: if a NULL parameter was sent or no reservations were found for today.
  *  and the amount of reservations for today otherwise.
  */
-int roomTodaysReservations(Room room);
+int roomTodaysReservations(Room room, int today);
 
 /*
  * Creates a new reservation for the room.
  * The reservation is taken into account by priority in the following way:
  * The room potentially has more urgent reservations (reservations that should
- * be implemented first = less days left / smaller hour value), so the new
- * reservation for the room will be added before / after certain reservations.
+ * be implemented first = earlier absolute time), so the new reservation for
+ * the room will be added before / after certain reservations.
  * 	$reservation: the parameter for this function has to be of type
- * 	"reservation", as defined in Reservation.h.
+ * 	"reservation", as defined in Reservation.h. On success, the room takes
+ * 	ownership of the reservation (it's not copied, and it will be deallocated
+ * 	by the room). Otherwise, the reservation stays the caller's.
  * #return:
  * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
  * 	ROOM_ALREADY_RESERVED - if the room is reserved in the exact hour and day
@@ -150,47 +182,75 @@ int roomTodaysReservations(Room room);
 RoomResult roomNewReservation(Room room, Reservation reservation);
 
 /*
- * Removes all reservations made by an escaper with the parameter email from
- * this room.
- * 	$email: Email of the escaper.
+ * Removes (and deallocates) the room's reservation at a certain time.
+ *  $time: The absolute time of the reservation (hours from the start of the
+ *  system's first day).
  * #return:
  * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
+ * 	ROOM_INVALID_PARAMETER - if the room has no reservation at that time.
  * 	ROOM_SUCCESS - otherwise.
  */
-RoomResult roomRemoveEscaperReservations(Room room, char* email);
+RoomResult roomRemoveReservation(Room room, int time);
 
 /*
- * Finds a reservation that's scheduled for a certain hours away from now.
- *  $hours_left: The amount of hours left for the reservation.
+ * Finds a reservation that's scheduled for a certain time.
+ *  $time: The absolute time of the reservation (hours from the start of the
+ *  system's first day).
  * #return:
  *  NULL - If a NULL parameter was sent or a reservation wasn't found
  *  and the desired reservation otherwise.
  */
-Reservation roomGetReservationInTime(Room room, int hours_left);
+Reservation roomGetReservationInTime(Room room, int time);
 
 /*
  * Gets the address of two parameters: days and hour. The values that these
  * pointers point to are the integer values of a MINIMUM days-hour combination
- * of a reservation to this room. Finds the nearest available day-hour
+ * of a reservation to this room (days are counted from the system's first
+ * day). Finds the nearest available day-hour
  * combination that's bigger than the parameter day-hour combination when the
  * escape room is open and NOT reserved, and UPDATES the values that the days
  * and hour pointer point to, to be the days and hour found.
+ * 	$busy - The hours that are taken anyway (for example, the schedule of the
+ * 	escaper who orders). The hour found is free in both the room and this map.
+ * 	Can be sent as NULL if only the room's reservations matter.
  * 	$days - The days pointer,
  * 	$hour - The hour pointer.
  * #return:
  * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
  * 	ROOM_SUCCESS - otherwise.
  */
-RoomResult roomGetEarliestTimeAvailable(Room room, int* days, int* hour);
+RoomResult roomGetEarliestTimeAvailable(Room room, Occupancy busy, int* days,
+int* hour);
+
+/*
+ * Fulfills all the reservations that were for today (or before). Since
+ * reservations are kept by absolute time, the future reservations of the room
+ * are not affected.
+ * 	$today: The system's current day.
+ * 	$earns: Address where the money the room has earned from the fulfilled
+ * 	reservations will be stored. Can be sent as NULL if it's not needed.
+ * #return:
+ * 	ROOM_NULL_PARAMETER - if a NULL pointer was sent.
+ * 	ROOM_SUCCESS - otherwise.
+ */
+RoomResult roomNextDay(Room room, int today, int* earns);
 
 /*
- * Decreases the room's reservations' scheduled days by one, and fulfills all
- * the reservations that were for today.
+ * Returns the room's earliest reservation, and sets the room's internal
+ * iterator to it. Used in order to go over the room's reservations.
  * #return:
- * 	RESERVATION_NULL_PARAMETER - if a NULL pointer was sent.
- * 	RESERVATION_SUCCESS - otherwise.
+ * 	NULL - If a NULL pointer was sent or the room has no reservations,
+ * 	and the earliest reservation otherwise.
  */
-RoomResult roomNextDay(Room room);
+Reservation roomFirstReservation(Room room);
+
+/*
+ * Advances the room's internal iterator to the next reservation (by time).
+ * #return:
+ * 	NULL - If a NULL pointer was sent or there are no more reservations,
+ * 	and the next reservation otherwise.
+ */
+Reservation roomNextReservation(Room room);
 
 /* Calculates a room's recommended score according to reservation parameters.
  * It compares the escaper's skill with the room's
@@ -204,4 +264,13 @@ RoomResult roomNextDay(Room room);
  */
 int roomCalculatedScore(Room room, int escaper_skill, int participants);
 
+/*
+ * Macro for iterating over the room's reservations, from the earliest to the
+ * latest.
+ */
+#define ROOM_FOREACH(reservation, room) \
+	for(Reservation reservation = roomFirstReservation(room); \
+		reservation != NULL; \
+		reservation = roomNextReservation(room))
+
 #endif /* ROOM_H_ */
@@ -0,0 +1,350 @@
+#include "RoomGrid.h"
+
+/*
+ * An entry of a cell: a room, with the fields it's sorted by.
+ */
+typedef struct GridEntry_t {
+	TechnionFaculty faculty; //The faculty of the company that owns the room.
+	int id; //The room's id.
+	Room room; //The room.
+} GridEntry;
+
+/*
+ * A cell of the grid: the rooms of a certain difficulty and a certain
+ * recommended amount of people, sorted by faculty and then by id.
+ */
+typedef struct GridCell_t {
+	int people; //The recommended amount of people of the cell's rooms.
+	GridEntry* entries; //The cell's rooms.
+	int capacity; //The amount of entries the array can hold.
+	int size; //The amount of rooms in the cell.
+} GridCell;
+
+/*
+ * A row of the grid: the cells of a certain difficulty, sorted by their
+ * recommended amount of people. A cell is in the row iff it has rooms.
+ */
+typedef struct GridRow_t {
+	GridCell* cells; //The row's cells.
+	int capacity; //The amount of cells the array can hold.
+	int size; //The amount of cells in the row.
+} GridRow;
+
+//The lowest and highest difficulties of a room.
+#define MIN_DIFFICULTY 1
+#define MAX_DIFFICULTY 10
+
+/*
+ * Implementation of the RoomGrid ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "RoomGrid".
+ */
+struct RoomGrid_t {
+	GridRow rows[MAX_DIFFICULTY - MIN_DIFFICULTY + 1]; //A row per difficulty.
+};
+
+//The initial amount of cells in a row, and of entries in a cell.
+#define INITIAL_SIZE 4
+
+//The arrays grow by this factor each time.
+#define GROWTH_FACTOR 2
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for assigning a value to a pointer iff it's not NULL.
+ */
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+/*
+ * A macro for the distance between two faculties.
+ */
+#define ABSOLUTE_DISTANCE(x, y) ((x) < (y) ? ((y)-(x)) : ((x)-(y)))
+
+static GridRow* findRow(RoomGrid grid, Room room);
+static int findCell(GridRow* row, int people, bool* found);
+static int compareEntry(GridEntry* entry, TechnionFaculty faculty, int id);
+static int findEntry(GridCell* cell, TechnionFaculty faculty, int id,
+bool* found);
+static bool growRow(GridRow* row);
+static bool growCell(GridCell* cell);
+static bool ranksBefore(GridEntry* entry1, GridEntry* entry2,
+TechnionFaculty escaper_faculty);
+static GridEntry* bestEntry(GridCell* cell, TechnionFaculty escaper_faculty);
+
+/*
+ * A static function that returns the row of a room's difficulty.
+ * #return:
+ * 	NULL if the room's difficulty is out of range, and its row otherwise.
+ */
+static GridRow* findRow(RoomGrid grid, Room room) {
+	assert(grid && room);
+	int difficulty = 0;
+	roomGetDifficulty(room, &difficulty);
+	CHECK_VALID(((difficulty >= MIN_DIFFICULTY) &&
+	(difficulty <= MAX_DIFFICULTY)), NULL)
+	return &(grid->rows[difficulty - MIN_DIFFICULTY]);
+}
+
+/*
+ * A static function that finds the place of a recommended amount of people in
+ * a row (binary search).
+ * 	$found: Address where we store whether the row has a cell for the amount.
+ * #return:
+ * 	The place of the amount's cell if it's in the row, and otherwise - the
+ * 	place where it should be inserted (the first cell with a bigger amount).
+ */
+static int findCell(GridRow* row, int people, bool* found) {
+	assert(row && found);
+	int low = 0, high = row->size;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(row->cells[middle].people < people)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*found = ((low < row->size) && (row->cells[low].people == people));
+	return low;
+}
+
+/*
+ * A static function that compares an entry with a (faculty, id) key.
+ * #return:
+ * 	A negative number if the entry comes before the key, 0 if they're equal and
+ * 	a positive number otherwise.
+ */
+static int compareEntry(GridEntry* entry, TechnionFaculty faculty, int id) {
+	assert(entry);
+	if(entry->faculty != faculty)
+		return ((int)(entry->faculty) - (int)faculty);
+	return (entry->id - id);
+}
+
+/*
+ * A static function that finds the place of a key in a cell (binary search).
+ * 	$found: Address where we store whether the key is in the cell.
+ * #return:
+ * 	The place of the key in the cell if it's there, and otherwise - the place
+ * 	where it should be inserted.
+ */
+static int findEntry(GridCell* cell, TechnionFaculty faculty, int id,
+bool* found) {
+	assert(cell && found);
+	int low = 0, high = cell->size;
+	while(low < high) {
+		int middle = low + (high-low)/2;
+		if(compareEntry(&(cell->entries[middle]), faculty, id) < 0)
+			low = middle+1;
+		else
+			high = middle;
+	}
+	*found = ((low < cell->size) &&
+	(compareEntry(&(cell->entries[low]), faculty, id) == 0));
+	return low;
+}
+
+/*
+ * A static function that makes room for more cells in a row.
+ * #return:
+ * 	false - if an allocation has failed (the row is left unchanged),
+ * 	true - otherwise.
+ */
+static bool growRow(GridRow* row) {
+	assert(row);
+	int new_capacity = (row->capacity == 0) ? (INITIAL_SIZE) :
+	(row->capacity*GROWTH_FACTOR);
+	GridCell* new_cells = realloc(row->cells, new_capacity*sizeof(*new_cells));
+	CHECK_VALID(new_cells, false)
+	row->cells = new_cells;
+	row->capacity = new_capacity;
+	return true;
+}
+
+/*
+ * A static function that makes room for more entries in a cell.
+ * #return:
+ * 	false - if an allocation has failed (the cell is left unchanged),
+ * 	true - otherwise.
+ */
+static bool growCell(GridCell* cell) {
+	assert(cell);
+	int new_capacity = (cell->capacity == 0) ? (INITIAL_SIZE) :
+	(cell->capacity*GROWTH_FACTOR);
+	GridEntry* new_entries = realloc(cell->entries,
+	new_capacity*sizeof(*new_entries));
+	CHECK_VALID(new_entries, false)
+	cell->entries = new_entries;
+	cell->capacity = new_capacity;
+	return true;
+}
+
+/*
+ * A static function that checks if a room should be recommended before another
+ * (of the same score): the room of the closer faculty to the escaper's comes
+ * first, then the room of the lower faculty and then the room with the lower
+ * id.
+ * 	$entry2: Can be NULL, and then the first room comes first.
+ */
+static bool ranksBefore(GridEntry* entry1, GridEntry* entry2,
+TechnionFaculty escaper_faculty) {
+	assert(entry1);
+	CHECK_VALID(entry2, true)
+	int distance1 = ABSOLUTE_DISTANCE(entry1->faculty, escaper_faculty),
+	distance2 = ABSOLUTE_DISTANCE(entry2->faculty, escaper_faculty);
+	if(distance1 != distance2)
+		return (distance1 < distance2);
+	if(entry1->faculty != entry2->faculty)
+		return (entry1->faculty < entry2->faculty);
+	return (entry1->id < entry2->id);
+}
+
+/*
+ * A static function that finds the room of a cell that should be recommended
+ * first. The closest faculty to the escaper's is either the first faculty
+ * that's not lower than it, or the last faculty that's lower than it, so only
+ * the lowest id rooms of these two faculties are compared.
+ */
+static GridEntry* bestEntry(GridCell* cell, TechnionFaculty escaper_faculty) {
+	assert(cell && (cell->size > 0));
+	bool found = false;
+	//Room ids are positive, so (faculty, 0) comes before all of its rooms.
+	int above = findEntry(cell, escaper_faculty, 0, &found);
+	GridEntry* best = (above < cell->size) ? (&(cell->entries[above])) : (NULL);
+	if(above > 0) {
+		int below = findEntry(cell, cell->entries[above-1].faculty, 0, &found);
+		if(ranksBefore(&(cell->entries[below]), best, escaper_faculty))
+			best = &(cell->entries[below]);
+	}
+	return best;
+}
+
+RoomGrid roomGridCreate() {
+	//The rows start with no cells: they're allocated on the first insertion.
+	RoomGrid grid = calloc(1, sizeof(*grid));
+	CHECK_VALID(grid, NULL)
+	return grid;
+}
+
+RoomGridResult roomGridDestroy(RoomGrid grid) {
+	CHECK_VALID(grid, ROOM_GRID_NULL_PARAMETER)
+	for(int i=0; i<=MAX_DIFFICULTY - MIN_DIFFICULTY; i++) {
+		for(int j=0; j<grid->rows[i].size; j++)
+			free(grid->rows[i].cells[j].entries);
+		free(grid->rows[i].cells);
+	}
+	free(grid);
+	return ROOM_GRID_SUCCESS;
+}
+
+RoomGridResult roomGridAdd(RoomGrid grid, TechnionFaculty faculty, Room room) {
+	CHECK_VALID(grid && room, ROOM_GRID_NULL_PARAMETER)
+	CHECK_VALID(((faculty >= 0) && (faculty < UNKNOWN)),
+	ROOM_GRID_INVALID_PARAMETER)
+	GridRow* row = findRow(grid, room);
+	CHECK_VALID(row, ROOM_GRID_INVALID_PARAMETER)
+	int people = 0, id = 0;
+	roomGetRecommendedPeople(room, &people);
+	roomGetId(room, &id);
+	bool found = false;
+	int place = findCell(row, people, &found);
+	if(!found) {
+		//The room opens a new cell. Both allocations are made before the row
+		//is changed, so a failure leaves the grid as it was.
+		GridEntry* entries = malloc(INITIAL_SIZE*sizeof(*entries));
+		CHECK_VALID(entries, ROOM_GRID_OUT_OF_MEMORY)
+		if((row->size == row->capacity) && !growRow(row)) {
+			free(entries);
+			return ROOM_GRID_OUT_OF_MEMORY;
+		}
+		memmove(&(row->cells[place+1]), &(row->cells[place]),
+		(row->size - place)*sizeof(*(row->cells)));
+		row->cells[place].people = people;
+		row->cells[place].entries = entries;
+		row->cells[place].capacity = INITIAL_SIZE;
+		row->cells[place].size = 0;
+		(row->size)++;
+	}
+	GridCell* cell = &(row->cells[place]);
+	int entry_place = findEntry(cell, faculty, id, &found);
+	CHECK_VALID(!found, ROOM_GRID_INVALID_PARAMETER)
+	if(cell->size == cell->capacity)
+		CHECK_VALID(growCell(cell), ROOM_GRID_OUT_OF_MEMORY)
+	memmove(&(cell->entries[entry_place+1]), &(cell->entries[entry_place]),
+	(cell->size - entry_place)*sizeof(*(cell->entries)));
+	cell->entries[entry_place].faculty = faculty;
+	cell->entries[entry_place].id = id;
+	cell->entries[entry_place].room = room;
+	(cell->size)++;
+	return ROOM_GRID_SUCCESS;
+}
+
+RoomGridResult roomGridRemove(RoomGrid grid, TechnionFaculty faculty,
+Room room) {
+	CHECK_VALID(grid && room, ROOM_GRID_NULL_PARAMETER)
+	CHECK_VALID(((faculty >= 0) && (faculty < UNKNOWN)),
+	ROOM_GRID_INVALID_PARAMETER)
+	GridRow* row = findRow(grid, room);
+	CHECK_VALID(row, ROOM_GRID_INVALID_PARAMETER)
+	int people = 0, id = 0;
+	roomGetRecommendedPeople(room, &people);
+	roomGetId(room, &id);
+	bool found = false;
+	int place = findCell(row, people, &found);
+	CHECK_VALID(found, ROOM_GRID_ROOM_DOES_NOT_EXIST)
+	GridCell* cell = &(row->cells[place]);
+	int entry_place = findEntry(cell, faculty, id, &found);
+	CHECK_VALID((found && (cell->entries[entry_place].room == room)),
+	ROOM_GRID_ROOM_DOES_NOT_EXIST)
+	memmove(&(cell->entries[entry_place]), &(cell->entries[entry_place+1]),
+	(cell->size - entry_place - 1)*sizeof(*(cell->entries)));
+	(cell->size)--;
+	if(cell->size == 0) {
+		//The cell has no more rooms, so it leaves the row.
+		free(cell->entries);
+		memmove(&(row->cells[place]), &(row->cells[place+1]),
+		(row->size - place - 1)*sizeof(*(row->cells)));
+		(row->size)--;
+	}
+	return ROOM_GRID_SUCCESS;
+}
+
+Room roomGridBestRoom(RoomGrid grid, int skill_level, int num_ppl,
+TechnionFaculty escaper_faculty, TechnionFaculty* faculty) {
+	CHECK_VALID(grid, NULL)
+	GridEntry* best = NULL;
+	int best_score = 0;
+	bool found = false;
+	for(int i=0; i<=MAX_DIFFICULTY - MIN_DIFFICULTY; i++) {
+		GridRow* row = &(grid->rows[i]);
+		//In a row, the best cells are the closest ones to the amount of
+		//people: the first cell that's not below it, and the one before it.
+		int place = findCell(row, num_ppl, &found);
+		for(int j = place-1; j <= place; j++) {
+			if((j < 0) || (j >= row->size))
+				continue;
+			GridCell* cell = &(row->cells[j]);
+			//All the rooms of a cell have the same score.
+			int score = roomCalculatedScore(cell->entries[0].room, skill_level,
+			num_ppl);
+			if(best && (score > best_score))
+				continue;
+			GridEntry* entry = bestEntry(cell, escaper_faculty);
+			if((!best) || (score < best_score) ||
+			ranksBefore(entry, best, escaper_faculty)) {
+				best = entry;
+				best_score = score;
+			}
+		}
+	}
+	CHECK_VALID(best, NULL)
+	INIT_IF_EXISTS(faculty, best->faculty);
+	return best->room;
+}
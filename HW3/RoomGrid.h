@@ -0,0 +1,88 @@
+#ifndef ROOMGRID_H_
+#define ROOMGRID_H_
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "Room.h"
+#include "mtm_ex3.h"
+
+typedef struct RoomGrid_t *RoomGrid; //Name of the ADT.
+
+typedef enum {
+	//The room grid's errors:
+	ROOM_GRID_SUCCESS,
+	ROOM_GRID_NULL_PARAMETER,
+	ROOM_GRID_INVALID_PARAMETER,
+	ROOM_GRID_OUT_OF_MEMORY,
+	ROOM_GRID_ROOM_DOES_NOT_EXIST,
+} RoomGridResult;
+
+/*
+ * Allocates a new, empty room grid.
+ * The grid places every room in a cell by its difficulty (a row for every
+ * difficulty, from 1 to 10) and its recommended amount of people (the cells of
+ * a row are sorted by it). Since a room's score for an escaper only depends on
+ * these two values, the rooms with the best score are found by looking at the
+ * cells that are closest to the escaper, instead of scoring every room.
+ * NOTE: The grid does not own the rooms it points to.
+ * #return:
+ * 	NULL if an allocation has failed,
+ * 	and a new room grid otherwise.
+ */
+RoomGrid roomGridCreate();
+
+/*
+ * Deallocates a room grid. The rooms the grid points to are not affected.
+ * #return:
+ * 	ROOM_GRID_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	ROOM_GRID_SUCCESS - Otherwise.
+ */
+RoomGridResult roomGridDestroy(RoomGrid grid);
+
+/*
+ * Adds a room to the grid.
+ * 	$faculty: The faculty of the company that owns the room.
+ * 	$room: The room. Its difficulty and recommended amount of people must not
+ * 	change while it's in the grid.
+ * #return:
+ * 	ROOM_GRID_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ROOM_GRID_INVALID_PARAMETER - If the faculty is invalid or the faculty
+ * 	already has a room with that id in the grid,
+ * 	ROOM_GRID_OUT_OF_MEMORY - If an allocation has failed,
+ * 	ROOM_GRID_SUCCESS - Otherwise.
+ */
+RoomGridResult roomGridAdd(RoomGrid grid, TechnionFaculty faculty, Room room);
+
+/*
+ * Removes a room from the grid.
+ * 	$faculty: The faculty of the company that owns the room.
+ * #return:
+ * 	ROOM_GRID_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ROOM_GRID_INVALID_PARAMETER - If the faculty is invalid,
+ * 	ROOM_GRID_ROOM_DOES_NOT_EXIST - If the room isn't in the grid,
+ * 	ROOM_GRID_SUCCESS - Otherwise.
+ */
+RoomGridResult roomGridRemove(RoomGrid grid, TechnionFaculty faculty,
+Room room);
+
+/*
+ * Finds the room with the best (lowest) score for an escaper, as calculated by
+ * roomCalculatedScore. If multiple rooms have the best score - the one that
+ * belongs to the faculty that's closest to the escaper's faculty is chosen
+ * (between two faculties at the same distance, the lower one), and then the
+ * one with the lowest id.
+ * 	$skill_level: The escaper's skill level.
+ * 	$num_ppl: The amount of people the escaper orders for.
+ * 	$escaper_faculty: The escaper's faculty.
+ * 	$faculty: Address where the faculty of the chosen room will be stored. Can
+ * 	be sent as NULL if it's not needed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent or the grid has no rooms,
+ * 	and the chosen room otherwise.
+ */
+Room roomGridBestRoom(RoomGrid grid, int skill_level, int num_ppl,
+TechnionFaculty escaper_faculty, TechnionFaculty* faculty);
+
+#endif /* ROOMGRID_H_ */
@@ -0,0 +1,142 @@
+#include "RoomIndex.h"
+
+/*
+ * An entry of a faculty's table: a room's id, the room and its company.
+ */
+typedef struct RoomEntry_t {
+	int id; //The room's id.
+	Room room; //The room.
+	struct Company_t* company; //The company that owns the room.
+} RoomEntry;
+
+/*
+ * Implementation of the RoomIndex ADT that's declared in the .h file:
+ * The struct's exposed name is of the pointer "RoomIndex".
+ */
+struct RoomIndex_t {
+	HashTable faculties[UNKNOWN]; //A table of room entries for every faculty.
+	RoomGrid grid; //The rooms, by their difficulty and recommended people.
+};
+
+//The initial amount of slots in a faculty's table. Must be a power of 2.
+#define INITIAL_CAPACITY 16
+
+/*
+ * A macro for checking the validity of a boolean condition.
+ * 	$bool_condition - any boolean condition.
+ * 	$res - the return value in case the boolean condition is false.
+ * If the boolean condition is "false" - returns error.
+ */
+#define CHECK_VALID(bool_condition, res) \
+	if(!(bool_condition)) { return res; }
+
+/*
+ * A macro for assigning a value to a pointer iff it's not NULL.
+ */
+#define INIT_IF_EXISTS(ptr, value) \
+	if(ptr) { (*ptr) = value; }
+
+static bool validKey(TechnionFaculty faculty, int id);
+static bool matchId(void* entry, void* id);
+static RoomEntry* findEntry(RoomIndex index, TechnionFaculty faculty, int id);
+
+/*
+ * A static function that checks that a faculty and a room id are valid keys.
+ */
+static bool validKey(TechnionFaculty faculty, int id) {
+	return ((faculty >= 0) && (faculty < UNKNOWN) && (id > 0));
+}
+
+/*
+ * A static function that checks whether a room entry has an id (the match
+ * function of the faculties' tables).
+ */
+static bool matchId(void* entry, void* id) {
+	return (((RoomEntry*)entry)->id == *(int*)id);
+}
+
+/*
+ * A static function that finds the entry of a room in its faculty's table.
+ * #return:
+ * 	NULL if there's no such room, and its entry otherwise.
+ */
+static RoomEntry* findEntry(RoomIndex index, TechnionFaculty faculty, int id) {
+	assert(index && validKey(faculty, id));
+	return hashTableFind(index->faculties[faculty], hashTableHashInt(id), &id);
+}
+
+RoomIndex roomIndexCreate() {
+	RoomIndex index = calloc(1, sizeof(*index));
+	CHECK_VALID(index, NULL)
+	index->grid = roomGridCreate();
+	bool created = (index->grid != NULL);
+	//The tables take no slots until their first rooms are added.
+	for(int i=0; created && (i<(int)UNKNOWN); i++) {
+		index->faculties[i] = hashTableCreate(NULL, sizeof(RoomEntry),
+		INITIAL_CAPACITY, matchId);
+		created = (index->faculties[i] != NULL);
+	}
+	if(!created) {
+		roomIndexDestroy(index);
+		return NULL;
+	}
+	return index;
+}
+
+RoomIndexResult roomIndexDestroy(RoomIndex index) {
+	CHECK_VALID(index, ROOM_INDEX_NULL_PARAMETER)
+	for(int i=0; i<(int)UNKNOWN; i++)
+		hashTableDestroy(index->faculties[i]);
+	roomGridDestroy(index->grid);
+	free(index);
+	return ROOM_INDEX_SUCCESS;
+}
+
+RoomIndexResult roomIndexAdd(RoomIndex index, TechnionFaculty faculty, int id,
+Room room, struct Company_t* company) {
+	CHECK_VALID(index && room && company, ROOM_INDEX_NULL_PARAMETER)
+	CHECK_VALID(validKey(faculty, id), ROOM_INDEX_INVALID_PARAMETER)
+	HashTableResult result = HASH_TABLE_SUCCESS;
+	RoomEntry* entry = hashTableInsert(&result, index->faculties[faculty],
+	hashTableHashInt(id), &id);
+	if(!entry)
+		return (result == HASH_TABLE_KEY_EXISTS) ? (ROOM_INDEX_ID_EXISTS) :
+		(ROOM_INDEX_OUT_OF_MEMORY);
+	//The id is new to the faculty, so the grid can only fail on memory.
+	if(roomGridAdd(index->grid, faculty, room) != ROOM_GRID_SUCCESS) {
+		hashTableRemove(index->faculties[faculty], entry);
+		return ROOM_INDEX_OUT_OF_MEMORY;
+	}
+	entry->id = id;
+	entry->room = room;
+	entry->company = company;
+	return ROOM_INDEX_SUCCESS;
+}
+
+RoomIndexResult roomIndexRemove(RoomIndex index, TechnionFaculty faculty,
+int id) {
+	CHECK_VALID(index, ROOM_INDEX_NULL_PARAMETER)
+	CHECK_VALID(validKey(faculty, id), ROOM_INDEX_INVALID_PARAMETER)
+	RoomEntry* entry = findEntry(index, faculty, id);
+	CHECK_VALID(entry, ROOM_INDEX_ID_DOES_NOT_EXIST)
+	roomGridRemove(index->grid, faculty, entry->room);
+	hashTableRemove(index->faculties[faculty], entry);
+	return ROOM_INDEX_SUCCESS;
+}
+
+Room roomIndexFind(RoomIndex index, TechnionFaculty faculty, int id,
+struct Company_t** company) {
+	CHECK_VALID(index, NULL)
+	CHECK_VALID(validKey(faculty, id), NULL)
+	RoomEntry* entry = findEntry(index, faculty, id);
+	CHECK_VALID(entry, NULL)
+	INIT_IF_EXISTS(company, entry->company);
+	return entry->room;
+}
+
+Room roomIndexBestRoom(RoomIndex index, int skill_level, int num_ppl,
+TechnionFaculty escaper_faculty, TechnionFaculty* faculty) {
+	CHECK_VALID(index, NULL)
+	return roomGridBestRoom(index->grid, skill_level, num_ppl, escaper_faculty,
+	faculty);
+}
@@ -0,0 +1,103 @@
+#ifndef ROOMINDEX_H_
+#define ROOMINDEX_H_
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "Room.h"
+#include "RoomGrid.h"
+#include "HashTable.h"
+#include "mtm_ex3.h"
+
+typedef struct RoomIndex_t *RoomIndex; //Name of the ADT.
+
+//The company ADT (declared in Company.h, which includes this file).
+struct Company_t;
+
+typedef enum {
+	//The room index's errors:
+	ROOM_INDEX_SUCCESS,
+	ROOM_INDEX_NULL_PARAMETER,
+	ROOM_INDEX_INVALID_PARAMETER,
+	ROOM_INDEX_OUT_OF_MEMORY,
+	ROOM_INDEX_ID_EXISTS,
+	ROOM_INDEX_ID_DOES_NOT_EXIST,
+} RoomIndexResult;
+
+/*
+ * Allocates a new, empty room index.
+ * The index holds a hash table for every faculty (see HashTable.h), which maps
+ * a room's id to the room and to the company that owns it. A room is therefore
+ * found by its (faculty, id) pair without going over the companies of the
+ * system. The rooms are also kept in a grid (see RoomGrid.h), so the best room
+ * for an escaper is found without scoring every room.
+ * NOTE: The index does not own the rooms nor the companies it points to.
+ * #return:
+ * 	NULL if an allocation has failed,
+ * 	and a new room index otherwise.
+ */
+RoomIndex roomIndexCreate();
+
+/*
+ * Deallocates a room index. The rooms and companies the index points to are
+ * not affected.
+ * #return:
+ * 	ROOM_INDEX_NULL_PARAMETER - If a NULL pointer was sent.
+ * 	ROOM_INDEX_SUCCESS - Otherwise.
+ */
+RoomIndexResult roomIndexDestroy(RoomIndex index);
+
+/*
+ * Adds a room to the index.
+ * 	$faculty: The faculty of the company that owns the room.
+ * 	$id: The room's id. Must be positive.
+ * 	$room: The room.
+ * 	$company: The company that owns the room.
+ * #return:
+ * 	ROOM_INDEX_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ROOM_INDEX_INVALID_PARAMETER - If the faculty or the id are invalid,
+ * 	ROOM_INDEX_ID_EXISTS - If the faculty already has a room with that id,
+ * 	ROOM_INDEX_OUT_OF_MEMORY - If an allocation has failed,
+ * 	ROOM_INDEX_SUCCESS - Otherwise.
+ */
+RoomIndexResult roomIndexAdd(RoomIndex index, TechnionFaculty faculty, int id,
+Room room, struct Company_t* company);
+
+/*
+ * Removes a room from the index.
+ * #return:
+ * 	ROOM_INDEX_NULL_PARAMETER - If a NULL pointer was sent,
+ * 	ROOM_INDEX_INVALID_PARAMETER - If the faculty or the id are invalid,
+ * 	ROOM_INDEX_ID_DOES_NOT_EXIST - If the faculty has no room with that id,
+ * 	ROOM_INDEX_SUCCESS - Otherwise.
+ */
+RoomIndexResult roomIndexRemove(RoomIndex index, TechnionFaculty faculty,
+int id);
+
+/*
+ * Finds a room by its faculty and id.
+ * 	$company: Address where the company that owns the room will be stored. Can
+ * 	be sent as NULL if the company is not needed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent, or there's no such room,
+ * 	and the room otherwise.
+ */
+Room roomIndexFind(RoomIndex index, TechnionFaculty faculty, int id,
+struct Company_t** company);
+
+/*
+ * Finds the room with the best score for an escaper. The rules for choosing
+ * between rooms of the same score are listed in roomGridBestRoom.
+ * 	$skill_level: The escaper's skill level.
+ * 	$num_ppl: The amount of people the escaper orders for.
+ * 	$escaper_faculty: The escaper's faculty.
+ * 	$faculty: Address where the faculty of the chosen room will be stored. Can
+ * 	be sent as NULL if it's not needed.
+ * #return:
+ * 	NULL - If a NULL pointer was sent, or there are no rooms in the index,
+ * 	and the chosen room otherwise.
+ */
+Room roomIndexBestRoom(RoomIndex index, int skill_level, int num_ppl,
+TechnionFaculty escaper_faculty, TechnionFaculty* faculty);
+
+#endif /* ROOMINDEX_H_ */
@@ -1,18 +1,55 @@
+#define _POSIX_C_SOURCE 200112L //For mmap, fstat, fileno, sockets & threads.
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 #include "EscapeTechnion.h"
+#include "Journal.h"
 
 #define INPUT_FILE_FLAG "-i"
 #define OUTPUT_FILE_FLAG "-o"
+#define BUFFERED_OUTPUT_FLAG "-b"
+#define LOAD_FILE_FLAG "-l"
+#define SAVE_FILE_FLAG "-s"
+#define JOURNAL_FILE_FLAG "-j"
+#define REPORT_WORKERS_FLAG "-p"
+#define SERVER_SOCKET_FLAG "-u"
 #define OPTION1_ARGS 0
 #define OPTION2_ARGS 2
 #define OPTION3_ARGS 4
+#define OPTION4_ARGS 6
+#define OPTION5_ARGS 8
+#define OPTION6_ARGS 10
+#define OPTION7_ARGS 12
+#define OPTION8_ARGS 14
 #define MAX_COMMAND_WORDS 8
-#define COMMANDS_AMOUNT 4
-#define SUB_COMMANDS_AMOUNT 6
 #define COMMENT_MARK '#'
+#define EMPTY_WORD ""
+#define PARAMETERS_INDEX 2 //The first parameter comes after the sub-command.
+#define DISPATCH_SLOTS 32 //Must be a power of 2, and more than COMMANDS_AMOUNT.
+#define EMPTY_DISPATCH_SLOT -1
+#define NULL_DEVICE "/dev/null" //Where the output of replayed commands goes.
+#define SERVER_WORKERS 8 //The amount of connections served at the same time.
+#define SERVER_BACKLOG 64 //The amount of connections waiting to be served.
+#define INVALID_NUMBER -1 //A numeric parameter that isn't a number.
+#define LOCK_STRIPES 64 //The amount of escaper (and room) locks. A power of 2.
+#define NO_STRIPE -1 //A lock that isn't held.
+#define FNV_OFFSET_BASIS 2166136261u //The initial value of an FNV-1a hash.
+#define FNV_PRIME 16777619u //The multiplier of an FNV-1a hash.
+
+/*
+ * A macro for checking if a character separates the words of a command line.
+ * The words of a command line are separated by spaces, tabs and its newline.
+ */
+#define IS_DELIMITER(c) (((c) == ' ') || ((c) == '\t') || ((c) == '\n'))
 
 /*
  * A macro for closing all the files before finishing the program.
@@ -22,69 +59,178 @@
 	fclose(out_file); \
 	fclose(err_file);
 
-/*
- * A macro for comparing commands and sub-commands, and assigning the correct
- * code value to a parameter code (and returning true, because we found a match)
- * The comparison is between "commands & str1", and "sub & str2".
- */
-#define TRY_CMD(str1, str2, command, sub, code, result) \
-	if ((strcmp(str1, command) == 0) && (strcmp(str2, sub) == 0)) { \
-		*code = result; \
-		return true; }
-
+typedef enum {
+	/*
+	 * The kinds of lines in the input: a command to execute, a comment (or an
+	 * empty line) to skip, and an invalid line that stops the program.
+	 */
+	LINE_COMMAND,
+	LINE_COMMENT,
+	LINE_INVALID
+} LineType;
 
 typedef enum {
 	/*
-	 * List of all the possible command & sub-command combinations.
-	 * For convince, we create a simple enum in order to save a code for the
-	 * current command once we've deciphered it!
-	 * Each combination is granted a code:
+	 * The locks a command is executed under in server mode: a command that
+	 * only reads a published view of the system takes none. An order (and a
+	 * recommendation) changes only its escaper and its room, so it takes their
+	 * locks and shares the system with the other orders. Any other command
+	 * takes the whole system.
 	 */
-	COMMAND_COMPANY_ADD,
-	COMMAND_COMPANY_REMOVE,
-	COMMAND_ROOM_ADD,
-	COMMAND_ROOM_REMOVE,
-	COMMAND_ESCAPER_ADD,
-	COMMAND_ESCAPER_REMOVE,
-	COMMAND_ESCAPER_ORDER,
-	COMMAND_ESCAPER_RECOMMEND,
-	COMMAND_REPORT_DAY,
-	COMMAND_REPORT_BEST,
-	COMMAND_COMMENT,
-	COMMAND_INVALID
-} CommandCode;
+	LOCKS_NONE,
+	LOCKS_ORDER,
+	LOCKS_RECOMMEND,
+	LOCKS_SYSTEM
+} CommandLocks;
 
+/*
+ * A function that executes a command, given the words of its command line,
+ * and returns the system's result.
+ */
+typedef EscapeTechnionResult (*CommandHandler)(EscapeTechnion system,
+FieldSlice* words);
 
+/*
+ * An entry of the command table: a command & sub-command combination, the
+ * amount of parameters that come after them, the function that executes it,
+ * whether it changes the system (and should be kept in the journal), and the
+ * locks it's executed under in server mode.
+ */
+typedef struct CommandEntry_t {
+	char* command;
+	char* sub_command;
+	int parameters;
+	CommandHandler handler;
+	bool changes_system;
+	CommandLocks locks;
+} CommandEntry;
+
+/*
+ * The state of the server mode, which is shared by all of its workers.
+ * The orders share the system's lock, and each of them holds the lock of its
+ * escaper and then the lock of its room (always in that order, so two orders
+ * never wait for each other's locks). An escaper's lock is the stripe of its email, and a
+ * room's lock is the stripe of its faculty and id, so orders of different
+ * escapers to different rooms are usually executed at the same time. The rest
+ * of the commands that change the system hold its lock alone. Every command
+ * passes through the turnstile before it takes the system's lock, and a
+ * command that waits to hold it alone stays in the turnstile meanwhile, so it
+ * isn't starved by a stream of orders.
+ */
+typedef struct Server_t {
+	EscapeTechnion system;
+	Journal journal;
+	int listen_fd; //The socket the connections are accepted on.
+	pthread_rwlock_t system_lock; //Shared by the orders, or held by one command.
+	pthread_mutex_t turnstile; //Passed through before taking the system's lock.
+	pthread_mutex_t escaper_locks[LOCK_STRIPES]; //The escapers' lock stripes.
+	pthread_mutex_t room_locks[LOCK_STRIPES]; //The rooms' lock stripes.
+	pthread_mutex_t clients_lock; //Guards the clients and the stopping flag.
+	int clients[SERVER_WORKERS]; //Each worker's connection (-1 if none).
+	bool stopping; //Whether the server is shutting down.
+} Server;
+
+/*
+ * The locks a worker holds while it executes a command.
+ */
+typedef struct HeldLocks_t {
+	bool system; //Whether the system's lock is held (shared or alone).
+	int escaper; //The stripe of the escaper's lock (or NO_STRIPE).
+	int room; //The stripe of the room's lock (or NO_STRIPE).
+} HeldLocks;
+
+/*
+ * A worker of the server: serves one connection after another.
+ */
+typedef struct ServerWorker_t {
+	Server* server;
+	int index; //The worker's place in the server's clients array.
+} ServerWorker;
 
 static bool print_error(EscapeTechnionResult result, FILE* error_file);
 static bool checkArgumentsNum(int arguments_num, FILE* err);
-static bool validCommand(char* cmd, CommandCode* code);
-static bool validSubCommand(char* cmd, char* sub, CommandCode* code);
-static bool validParametersAmount(int parameters, CommandCode* code);
-static bool handleCommandLine(char* buffer, char** words,
-CommandCode* code, int* parameters, FILE* err_file);
-static bool callCompanyAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callCompanyRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callRoomAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callRoomRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callEscaperAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callEscaperRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callEscaperOrder(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callEscaperRecommend(EscapeTechnion system, char** words,
-int parameters, FILE* err_file);
-static bool callReportDay(EscapeTechnion system, FILE* err_file);
-static bool callReportBest(EscapeTechnion system, FILE* err_file);
-static bool translateCommand(EscapeTechnion system, char** words,
-CommandCode code, int parameters, FILE* err_file);
-static void getCommands(EscapeTechnion system, FILE* input_file,
-FILE* output_file, FILE* err_file);
+static bool removeFlag(int* arguments_num, char** arguments, char* flag);
+static int readWorkers(char* argument);
+static int readNumber(FieldSlice word);
+static char* wordString(FieldSlice word, char* buffer);
+static bool isWord(FieldSlice word, char* string);
+static unsigned int hashWord(unsigned int hash, FieldSlice word);
+static unsigned int hashCommand(FieldSlice command, FieldSlice sub_command);
+static void buildDispatchTable();
+static const CommandEntry* findCommand(FieldSlice command,
+FieldSlice sub_command);
+static LineType validCommandLine(FieldSlice* words, int words_amount,
+const CommandEntry** entry, FILE* err_file);
+static int splitLine(char* line, int length, FieldSlice* words);
+static bool executeCommand(EscapeTechnion system, Journal journal,
+const CommandEntry* entry, FieldSlice* words, FILE* err_file, bool commit,
+bool alone);
+static EscapeTechnionResult callCompanyAdd(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callCompanyRemove(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callRoomAdd(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callRoomRemove(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callEscaperAdd(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callEscaperRemove(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callEscaperOrder(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callEscaperRecommend(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callReportDay(EscapeTechnion system,
+FieldSlice* words);
+static EscapeTechnionResult callReportBest(EscapeTechnion system,
+FieldSlice* words);
+static bool getMappedCommands(EscapeTechnion system, Journal journal,
+FILE* input_file, FILE* err_file);
+static EscapeTechnion loadSystem(char* load_path, FILE* err_file);
+static EscapeTechnion recoverSystem(Journal journal, FILE* err_file);
+static void finishCommands(EscapeTechnion system, Journal journal,
+char* save_path, FILE* input_file, FILE* output_file, FILE* err_file);
+static void getCommands(EscapeTechnion system, Journal journal,
+char* save_path, FILE* input_file, FILE* output_file, FILE* err_file);
+static int openServerSocket(char* socket_path);
+static int escaperStripe(FieldSlice email);
+static int roomStripe(int faculty, int id);
+static void lockSystem(Server* server, bool alone);
+static void lockCommand(Server* server, const CommandEntry* entry,
+FieldSlice* words, HeldLocks* held);
+static void unlockCommand(Server* server, HeldLocks* held);
+static bool commitCommand(Server* server, const CommandEntry* entry,
+FILE* err_file);
+static void serveClient(Server* server, int client_fd);
+static void* serverWorker(void* worker);
+static void runServer(EscapeTechnion system, Journal journal,
+char* save_path, char* socket_path, FILE* output_file, FILE* err_file);
+
+/*
+ * All the valid commands. A new command only needs a handler and a line here.
+ */
+static const CommandEntry commands[] = {
+	{"company", "add", 2, callCompanyAdd, true, LOCKS_SYSTEM},
+	{"company", "remove", 1, callCompanyRemove, true, LOCKS_SYSTEM},
+	{"room", "add", 6, callRoomAdd, true, LOCKS_SYSTEM},
+	{"room", "remove", 2, callRoomRemove, true, LOCKS_SYSTEM},
+	{"escaper", "add", 3, callEscaperAdd, true, LOCKS_SYSTEM},
+	{"escaper", "remove", 1, callEscaperRemove, true, LOCKS_SYSTEM},
+	{"escaper", "order", 5, callEscaperOrder, true, LOCKS_ORDER},
+	{"escaper", "recommend", 2, callEscaperRecommend, true, LOCKS_RECOMMEND},
+	{"report", "day", 0, callReportDay, true, LOCKS_SYSTEM},
+	{"report", "best", 0, callReportBest, false, LOCKS_NONE}
+};
+
+#define COMMANDS_AMOUNT ((int)(sizeof(commands)/sizeof(commands[0])))
+
+/*
+ * The dispatch table: an open addressing hash table (with linear probing) of
+ * indexes into the commands array, keyed by the command & sub-command pair.
+ * It's built once, before the input is read.
+ */
+static int dispatch_table[DISPATCH_SLOTS];
 
 /*
  * Gets the EscapeTechnion system's error and converts it to MTM ERROR CODE,
@@ -136,12 +282,14 @@ static bool print_error(EscapeTechnionResult result, FILE* error_file) {
 }
 
 /*
- * Checks that the number of arguments is 0, 2 or 4 (excluding the terminal's
- * executable name declaration).
+ * Checks that the number of arguments is even, and at most 14 (excluding the
+ * terminal's executable name declaration).
  */
 static bool checkArgumentsNum(int arguments_num, FILE* err_file) {
 	if(arguments_num!=OPTION1_ARGS+1 && arguments_num!=OPTION2_ARGS+1
-	&& arguments_num!=OPTION3_ARGS+1) {
+	&& arguments_num!=OPTION3_ARGS+1 && arguments_num!=OPTION4_ARGS+1
+	&& arguments_num!=OPTION5_ARGS+1 && arguments_num!=OPTION6_ARGS+1
+	&& arguments_num!=OPTION7_ARGS+1 && arguments_num!=OPTION8_ARGS+1) {
 		mtmPrintErrorMessage(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
 		fclose(err_file);
 		return false;
@@ -150,275 +298,486 @@ static bool checkArgumentsNum(int arguments_num, FILE* err_file) {
 }
 
 /*
- * Checks if a command is one of the valid commands, and returns true if it is.
- * Otherwise, returns false and updates the error code.
+ * Checks if a flag without a value was given (in a place where a flag is
+ * expected), and removes it from the arguments, so that only the "-i" and
+ * "-o" pairs are left. Returns true iff the flag was given.
  */
-static bool validCommand(char* cmd, CommandCode* code) {
-	char* commands[COMMANDS_AMOUNT] = {"company", "room", "escaper", "report"};
-	if(cmd[0] == COMMENT_MARK) {
-		*code = COMMAND_COMMENT;
-		return false;
+static bool removeFlag(int* arguments_num, char** arguments, char* flag) {
+	assert(arguments_num && arguments && flag);
+	for(int i=1; i<*arguments_num; i+=2) {
+		if(strcmp(arguments[i], flag) != 0)
+			continue;
+		for(int j=i; j<*arguments_num-1; j++)
+			arguments[j] = arguments[j+1];
+		(*arguments_num)--;
+		return true;
 	}
-	for(int i=0; i<COMMANDS_AMOUNT; i++)
-		if(strcmp(cmd, commands[i]) == 0)
-			return true;
-	*code = COMMAND_INVALID;
 	return false;
 }
 
 /*
- * Checks if a sub-command is one of the valid sub-commands, and returns true
- * if it is. Otherwise, returns false and updates the error code.
+ * Reads the amount of threads that build the day reports from its argument.
+ * Returns 0 if the argument isn't a positive number.
  */
-static bool validSubCommand(char* cmd, char* sub, CommandCode* code) {
-	TRY_CMD("company", "add", cmd, sub, code, COMMAND_COMPANY_ADD)
-	TRY_CMD("company", "remove", cmd, sub, code, COMMAND_COMPANY_REMOVE)
-	TRY_CMD("room", "add", cmd, sub, code, COMMAND_ROOM_ADD)
-	TRY_CMD("room", "remove", cmd, sub, code, COMMAND_ROOM_REMOVE)
-	TRY_CMD("escaper", "add", cmd, sub, code, COMMAND_ESCAPER_ADD)
-	TRY_CMD("escaper", "remove", cmd, sub, code, COMMAND_ESCAPER_REMOVE)
-	TRY_CMD("escaper", "order", cmd, sub, code, COMMAND_ESCAPER_ORDER)
-	TRY_CMD("escaper", "recommend", cmd, sub, code, COMMAND_ESCAPER_RECOMMEND)
-	TRY_CMD("report", "day", cmd, sub, code, COMMAND_REPORT_DAY)
-	TRY_CMD("report", "best", cmd, sub, code, COMMAND_REPORT_BEST)
-	*code = COMMAND_INVALID;
-	return false;
+static int readWorkers(char* argument) {
+	assert(argument);
+	int workers = 0;
+	if(!fieldReadInteger(argument, &workers) || (workers <= 0))
+		return 0;
+	return workers;
 }
 
 /*
- * Checks if the amount of parameters given with the command is valid. Returns
- * true if it is, and false if it isn't, and updates the error code.
- */
-static bool validParametersAmount(int parameters, CommandCode* code) {
-	switch(*code) {
-		case COMMAND_COMPANY_ADD:
-			return (parameters == 2);
-		case COMMAND_COMPANY_REMOVE:
-			return (parameters == 1);
-		case COMMAND_ROOM_ADD:
-			return (parameters == 6);
-		case COMMAND_ROOM_REMOVE:
-			return (parameters == 2);
-		case COMMAND_ESCAPER_ADD:
-			return (parameters == 3);
-		case COMMAND_ESCAPER_REMOVE:
-			return (parameters == 1);
-		case COMMAND_ESCAPER_ORDER:
-			return (parameters == 5);
-		case COMMAND_ESCAPER_RECOMMEND:
-			return (parameters == 2);
-		case COMMAND_REPORT_DAY:
-			return (parameters == 0);
-		case COMMAND_REPORT_BEST:
-			return (parameters == 0);
-		default:
-			*code = COMMAND_INVALID;
-			return false;
+ * Reads a numeric parameter of a command, straight from its command line. A
+ * parameter that isn't a number is read as INVALID_NUMBER, which all the
+ * numeric parameters reject.
+ */
+static int readNumber(FieldSlice word) {
+	int number = 0;
+	return (fieldReadIntegerSlice(word.start, word.length, &number)) ?
+	(number) : (INVALID_NUMBER);
+}
+
+/*
+ * Copies a word of a command line into a buffer, as a string, for the
+ * system's functions that take a string parameter (an email, a time or
+ * working hours). The other parameters are read straight from the line.
+ * 	$buffer: A buffer of MAX_LEN+1 characters (a word is never longer than the
+ * 	line it's in).
+ * #return:
+ * 	The buffer.
+ */
+static char* wordString(FieldSlice word, char* buffer) {
+	assert(buffer && (word.length <= MAX_LEN));
+	memcpy(buffer, word.start, word.length);
+	buffer[word.length] = '\0';
+	return buffer;
+}
+
+/*
+ * A static function that checks if a word of a command line is a string.
+ */
+static bool isWord(FieldSlice word, char* string) {
+	assert(string);
+	return (((int)strlen(string) == word.length) &&
+	(memcmp(word.start, string, word.length) == 0));
+}
+
+/*
+ * A static function that adds a word to an FNV-1a hash value.
+ */
+static unsigned int hashWord(unsigned int hash, FieldSlice word) {
+	for(int i=0; i<word.length; i++) {
+		hash ^= (unsigned char)(word.start[i]);
+		hash *= FNV_PRIME;
 	}
+	return hash;
 }
 
 /*
- * A static function for completely deciphering a command line. Updates the
- * command code and the parameters for this command (in the words array).
- * Returns false if the command is not one of the valid commands,
- * and true otherwise.
+ * A static function that calculates the hash value of a command & sub-command
+ * pair (FNV-1a over both words, with a separator between them).
  */
-static bool handleCommandLine(char* buffer, char** words, CommandCode* code,
-int* parameters, FILE* err_file) {
-	assert(buffer && words && code && err_file);
-	int index = 0;
-	char* token = strtok(buffer, " \t\n");
-	if(!token) {
-		*code = COMMAND_COMMENT;
-		return false;
+static unsigned int hashCommand(FieldSlice command, FieldSlice sub_command) {
+	FieldSlice separator = {" ", 1};
+	return hashWord(hashWord(hashWord(FNV_OFFSET_BASIS, command), separator),
+	sub_command);
+}
+
+/*
+ * A static function that places every command of the commands array in the
+ * dispatch table.
+ */
+static void buildDispatchTable() {
+	assert(COMMANDS_AMOUNT < DISPATCH_SLOTS);
+	for(int i=0; i<DISPATCH_SLOTS; i++)
+		dispatch_table[i] = EMPTY_DISPATCH_SLOT;
+	for(int i=0; i<COMMANDS_AMOUNT; i++) {
+		FieldSlice command = {commands[i].command,
+		strlen(commands[i].command)};
+		FieldSlice sub_command = {commands[i].sub_command,
+		strlen(commands[i].sub_command)};
+		unsigned int slot = hashCommand(command, sub_command) &
+		(DISPATCH_SLOTS - 1);
+		while(dispatch_table[slot] != EMPTY_DISPATCH_SLOT)
+			slot = (slot + 1) & (DISPATCH_SLOTS - 1);
+		dispatch_table[slot] = i;
 	}
-	while(words[index] && token) {
-		strcpy(words[index++], token);
-		token = strtok(NULL, " \t\n");
+}
+
+/*
+ * A static function that finds a command & sub-command pair in the dispatch
+ * table.
+ * #return:
+ * 	NULL if the pair isn't a valid command, and its entry otherwise.
+ */
+static const CommandEntry* findCommand(FieldSlice command,
+FieldSlice sub_command) {
+	unsigned int slot = hashCommand(command, sub_command) &
+	(DISPATCH_SLOTS - 1);
+	while(dispatch_table[slot] != EMPTY_DISPATCH_SLOT) {
+		const CommandEntry* entry = &commands[dispatch_table[slot]];
+		if(isWord(command, entry->command) &&
+		isWord(sub_command, entry->sub_command))
+			return entry;
+		slot = (slot + 1) & (DISPATCH_SLOTS - 1);
 	}
-	if((words[0]) && (!validCommand(words[0], code))) {
-		if(*code == COMMAND_INVALID)
-			mtmPrintErrorMessage
-			(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
-		return false;
+	return NULL;
+}
+
+/*
+ * A static function for deciphering the words of a command line. If the line
+ * is a valid command, its entry in the commands array is stored in "entry".
+ * Prints an error if the line is invalid.
+ * 	$words_amount: The amount of words in the command line. Only the first
+ * 	MAX_COMMAND_WORDS of them are in the words array.
+ * #return:
+ * 	LINE_COMMENT - If the line is empty or a comment,
+ * 	LINE_INVALID - If the line isn't a valid command, or the amount of
+ * 	parameters doesn't match the command,
+ * 	LINE_COMMAND - Otherwise.
+ */
+static LineType validCommandLine(FieldSlice* words, int words_amount,
+const CommandEntry** entry, FILE* err_file) {
+	assert(words && entry && err_file);
+	if((words_amount == 0) || (words[0].start[0] == COMMENT_MARK))
+		return LINE_COMMENT;
+	*entry = (words_amount < PARAMETERS_INDEX) ? NULL :
+	findCommand(words[0], words[1]);
+	if(!(*entry) || (words_amount-PARAMETERS_INDEX != (*entry)->parameters)) {
+		mtmPrintErrorMessage(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
+		return LINE_INVALID;
 	}
-	if((words[1]) && (!validSubCommand(words[0], words[1], code))) {
-		if(*code == COMMAND_INVALID)
-			mtmPrintErrorMessage
-			(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
-		return false;
+	return LINE_COMMAND;
+}
+
+/*
+ * A static function that splits a command line into words, without changing
+ * it: the words array gets the slices of the line that hold the words, so
+ * nothing is copied or terminated.
+ * 	$length: The length of the line.
+ * 	$words: An array of MAX_COMMAND_WORDS slices. The words that don't fit in
+ * 	it are counted but not stored, and the unused slices are set to an empty
+ * 	word.
+ * #return:
+ * 	The amount of words in the line.
+ */
+static int splitLine(char* line, int length, FieldSlice* words) {
+	assert(line && words);
+	int amount = 0, i = 0;
+	while(i < length) {
+		while((i < length) && IS_DELIMITER(line[i]))
+			i++;
+		if(i == length)
+			break;
+		int start = i;
+		while((i < length) && !IS_DELIMITER(line[i]))
+			i++;
+		if(amount < MAX_COMMAND_WORDS) {
+			words[amount].start = line+start;
+			words[amount].length = i-start;
+		}
+		amount++;
 	}
-	if(!validParametersAmount(index-2, code)) {
-		mtmPrintErrorMessage(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
-		return false;
+	for(int j=amount; j<MAX_COMMAND_WORDS; j++) {
+		words[j].start = EMPTY_WORD;
+		words[j].length = 0;
 	}
-	*parameters = index-2;
-	return true;
+	return amount;
+}
+
+/*
+ * A static function that executes a valid command: prints the system's error
+ * (if there is one) to the error stream, and if the command has changed the
+ * system - appends it to the journal (if there is one).
+ * 	$commit: Whether the command is acknowledged as soon as it's executed (a
+ * 	line of a stream, and not of a whole file that was read at once), so it's
+ * 	synced to the disk before this function returns. Otherwise, the journal
+ * 	syncs its commands in groups.
+ * 	$alone: Whether no other thread changes the system at the same time, so a
+ * 	snapshot can be started right after the command (if one is due).
+ * #return:
+ * 	false - If a memory problem has occurred or the journal couldn't be
+ * 	written (the input should no longer be read), true - otherwise.
+ */
+static bool executeCommand(EscapeTechnion system, Journal journal,
+const CommandEntry* entry, FieldSlice* words, FILE* err_file, bool commit,
+bool alone) {
+	assert(system && entry && words && err_file);
+	EscapeTechnionResult result = entry->handler(system, words);
+	if(!print_error(result, err_file))
+		return false;
+	if(!journal || !(entry->changes_system) ||
+	(result != ESCAPE_TECHNION_SUCCESS))
+		return true;
+	JournalResult journal_result = journalAppend(journal, words,
+	PARAMETERS_INDEX + entry->parameters);
+	if((journal_result == JOURNAL_SUCCESS) && commit)
+		journal_result = journalCommit(journal);
+	if((journal_result == JOURNAL_SUCCESS) && alone)
+		journal_result = journalSnapshot(journal, system);
+	if(journal_result == JOURNAL_SUCCESS)
+		return true;
+	mtmPrintErrorMessage(err_file, (journal_result == JOURNAL_OUT_OF_MEMORY) ?
+	(MTM_OUT_OF_MEMORY) : (MTM_CANNOT_OPEN_FILE));
+	return false;
 }
 
 /*
- * Calls the system's company add function, prints the error (if there is one)
- * to the error stream, and returns false iff a memory problem has occurred
- * (true otherwise)
+ * Calls the system's company add function, and returns its result.
  */
-static bool callCompanyAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callCompanyAdd(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionAddCompany(system,
-	words[params_index], (TechnionFaculty)atoi(words[params_index+1]));
-	return print_error(result, err_file);
+	wordString(words[params_index], email),
+	(TechnionFaculty)readNumber(words[params_index+1]));
+	return result;
 }
 
 /*
- * Calls the system's company remove function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's company remove function, and returns its result.
  */
-static bool callCompanyRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callCompanyRemove(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionRemoveCompany(system,
-	words[params_index]);
-	return print_error(result, err_file);
+	wordString(words[params_index], email));
+	return result;
 }
 
 /*
- * Calls the system's room add function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's room add function, and returns its result.
  */
-static bool callRoomAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callRoomAdd(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1], working_hours[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionAddRoom(system,
-	words[params_index], atoi(words[params_index+1]),
-	atoi(words[params_index+2]), atoi(words[params_index+3]),
-	words[params_index+4], atoi(words[params_index+5]));
-	return print_error(result, err_file);
+	wordString(words[params_index], email), readNumber(words[params_index+1]),
+	readNumber(words[params_index+2]), readNumber(words[params_index+3]),
+	wordString(words[params_index+4], working_hours),
+	readNumber(words[params_index+5]));
+	return result;
 }
 
 /*
- * Calls the system's room remove function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's room remove function, and returns its result.
  */
-static bool callRoomRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callRoomRemove(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
 	EscapeTechnionResult result = escapeTechnionRemoveRoom(system,
-	(TechnionFaculty)atoi(words[params_index]), atoi(words[params_index+1]));
-	return print_error(result, err_file);
+	(TechnionFaculty)readNumber(words[params_index]),
+	readNumber(words[params_index+1]));
+	return result;
 }
 
 /*
- * Calls the system's escaper add function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's escaper add function, and returns its result.
  */
-static bool callEscaperAdd(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callEscaperAdd(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionAddEscaper(system,
-	words[params_index], (TechnionFaculty)atoi(words[params_index+1]),
-	atoi(words[params_index+2]));
-	return print_error(result, err_file);
+	wordString(words[params_index], email),
+	(TechnionFaculty)readNumber(words[params_index+1]),
+	readNumber(words[params_index+2]));
+	return result;
 }
 
 /*
- * Calls the system's escaper remove function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's escaper remove function, and returns its result.
  */
-static bool callEscaperRemove(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callEscaperRemove(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionRemoveEscaper(system,
-	words[params_index]);
-	return print_error(result, err_file);
+	wordString(words[params_index], email));
+	return result;
 }
 
 /*
- * Calls the system's escaper order function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's escaper order function, and returns its result.
  */
-static bool callEscaperOrder(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callEscaperOrder(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1], time[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionEscaperOrder(system,
-	words[params_index], (TechnionFaculty)atoi(words[params_index+1]),
-	atoi(words[params_index+2]), words[params_index+3],
-	atoi(words[params_index+4]));
-	return print_error(result, err_file);
+	wordString(words[params_index], email),
+	(TechnionFaculty)readNumber(words[params_index+1]),
+	readNumber(words[params_index+2]), wordString(words[params_index+3], time),
+	readNumber(words[params_index+4]));
+	return result;
 }
 
 /*
- * Calls the system's escaper recommend function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
+ * Calls the system's escaper recommend function, and returns its result.
  */
-static bool callEscaperRecommend(EscapeTechnion system, char** words,
-int parameters, FILE* err_file) {
-	int params_index = 2;
+static EscapeTechnionResult callEscaperRecommend(EscapeTechnion system,
+FieldSlice* words) {
+	int params_index = PARAMETERS_INDEX;
+	char email[MAX_LEN+1];
 	EscapeTechnionResult result = escapeTechnionEscaperRecommend(system,
-	words[params_index], atoi(words[params_index+1]));
-	return print_error(result, err_file);
-}
-
-/*
- * Calls the system's report day function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
- */
-static bool callReportDay(EscapeTechnion system, FILE* err_file) {
-	EscapeTechnionResult result = escapeTechnionReportDay(system);
-	return print_error(result, err_file);
-}
-
-/*
- * Calls the system's report best function, prints the error
- * (if there is one) to the error stream, and returns false iff a memory
- * problem has occurred (true otherwise)
- */
-static bool callReportBest(EscapeTechnion system, FILE* err_file) {
-	EscapeTechnionResult result = escapeTechnionReportBest(system);
-	return print_error(result, err_file);
-}
-
-/*
- * Calls one of the system's functions, according to the command given.
- * The correct function is chosen according to the code assigned at the
- * deciphering stage that came before it. All that's left is to select
- * the function that matches our code! This function returns false
- * iff a memory problem has occured.
- */
-static bool translateCommand(EscapeTechnion system, char** words,
-CommandCode code, int parameters, FILE* err_file) {
-	switch((int)code) {
-		case COMMAND_COMPANY_ADD:
-			return callCompanyAdd(system, words, parameters, err_file);
-		case COMMAND_COMPANY_REMOVE:
-			return callCompanyRemove(system, words, parameters, err_file);
-		case COMMAND_ROOM_ADD:
-			return callRoomAdd(system, words, parameters, err_file);
-		case COMMAND_ROOM_REMOVE:
-			return callRoomRemove(system, words, parameters, err_file);
-		case COMMAND_ESCAPER_ADD:
-			return callEscaperAdd(system, words, parameters, err_file);
-		case COMMAND_ESCAPER_REMOVE:
-			return callEscaperRemove(system, words, parameters, err_file);
-		case COMMAND_ESCAPER_ORDER:
-			return callEscaperOrder(system, words, parameters, err_file);
-		case COMMAND_ESCAPER_RECOMMEND:
-			return callEscaperRecommend(system, words, parameters, err_file);
-		case COMMAND_REPORT_DAY:
-			return callReportDay(system, err_file);
-		case COMMAND_REPORT_BEST:
-			return callReportBest(system, err_file);
-		default:
-			return false;
+	wordString(words[params_index], email), readNumber(words[params_index+1]));
+	return result;
+}
+
+/*
+ * Calls the system's report day function, and returns its result.
+ */
+static EscapeTechnionResult callReportDay(EscapeTechnion system,
+FieldSlice* words) {
+	return escapeTechnionReportDay(system);
+}
+
+/*
+ * Calls the system's report best function, and returns its result.
+ */
+static EscapeTechnionResult callReportBest(EscapeTechnion system,
+FieldSlice* words) {
+	return escapeTechnionReportBest(system);
+}
+
+/*
+ * Reads all of the commands of an input file by mapping it to memory (instead
+ * of copying it line after line). The mapping is read-only: every line is
+ * split into slices of the mapping, and the numbers are read straight from
+ * them, so the file's pages are only read. The file is split into the same
+ * lines fgets would read (at most MAX_LEN characters each), so the commands
+ * are handled exactly as they are with getCommands' loop.
+ * #return:
+ * 	false - If the file couldn't be mapped (it's empty, or isn't a regular
+ * 	file). Nothing was read, and the caller should read it as a stream.
+ * 	true - Otherwise (the commands were read until the end of the file or
+ * 	until a fatal error).
+ */
+static bool getMappedCommands(EscapeTechnion system, Journal journal,
+FILE* input_file, FILE* err_file) {
+	assert(system && input_file && err_file);
+	struct stat file_stat;
+	int fd = fileno(input_file);
+	if((fd < 0) || (fstat(fd, &file_stat) != 0) ||
+	!S_ISREG(file_stat.st_mode) || (file_stat.st_size <= 0))
+		return false;
+	size_t size = (size_t)file_stat.st_size;
+	char* input = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if(input == MAP_FAILED)
+		return false;
+	posix_madvise(input, size, POSIX_MADV_SEQUENTIAL);
+	FieldSlice words[MAX_COMMAND_WORDS];
+	size_t position = 0;
+	while(position < size) {
+		char* line = input+position;
+		size_t limit = ((size-position) < MAX_LEN) ? (size-position) : MAX_LEN;
+		char* line_end = memchr(line, '\n', limit);
+		int length = line_end ? (int)(line_end-line+1) : (int)limit;
+		position += length;
+		const CommandEntry* entry = NULL;
+		int words_amount = splitLine(line, length, words);
+		LineType type = validCommandLine(words, words_amount, &entry,
+		err_file);
+		if(type == LINE_INVALID)
+			break;
+		if(type == LINE_COMMENT)
+			continue;
+		if(!executeCommand(system, journal, entry, words, err_file, false,
+		true))
+			break;
 	}
-	return false;
+	munmap(input, size);
+	return true;
+}
+
+/*
+ * Creates the system. If a checkpoint file was given, the system is loaded
+ * from it instead of starting empty. Prints an error and returns NULL if the
+ * system couldn't be created.
+ */
+static EscapeTechnion loadSystem(char* load_path, FILE* err_file) {
+	if(!load_path)
+		return escapeTechnionCreate();
+	FILE* load_file = fopen(load_path, "rb");
+	if(!load_file) {
+		mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+		return NULL;
+	}
+	EscapeTechnionResult result = ESCAPE_TECHNION_SUCCESS;
+	EscapeTechnion system = escapeTechnionLoad(&result, load_file);
+	fclose(load_file);
+	if(!system)
+		mtmPrintErrorMessage(err_file,
+		(result == ESCAPE_TECHNION_OUT_OF_MEMORY) ?
+		(MTM_OUT_OF_MEMORY) : (MTM_CANNOT_OPEN_FILE));
+	return system;
+}
+
+/*
+ * Recovers the system from a journal: the journal's snapshot is loaded, and
+ * the commands that came after it are executed again. The commands were
+ * already executed successfully before, so their output (and errors) aren't
+ * printed again. Prints an error and returns NULL if the system couldn't be
+ * recovered.
+ */
+static EscapeTechnion recoverSystem(Journal journal, FILE* err_file) {
+	assert(journal && err_file);
+	JournalResult result = JOURNAL_SUCCESS;
+	EscapeTechnion system = journalRecover(journal, &result);
+	FILE* null_file = system ? fopen(NULL_DEVICE, "w") : NULL;
+	if(!null_file) {
+		mtmPrintErrorMessage(err_file, (result == JOURNAL_OUT_OF_MEMORY) ?
+		(MTM_OUT_OF_MEMORY) : (MTM_CANNOT_OPEN_FILE));
+		escapeTechnionDestroy(system);
+		return NULL;
+	}
+	//The null device is closed by the system once its output is changed.
+	escapeTechnionModifyOutput(system, null_file);
+	FieldSlice words[MAX_COMMAND_WORDS];
+	char* line = journalNextCommand(journal);
+	while(line) {
+		const CommandEntry* entry = NULL;
+		int words_amount = splitLine(line, strlen(line), words);
+		if((validCommandLine(words, words_amount, &entry, null_file) ==
+		LINE_COMMAND) && !print_error(entry->handler(system, words), null_file)) {
+			mtmPrintErrorMessage(err_file, MTM_OUT_OF_MEMORY);
+			escapeTechnionDestroy(system);
+			return NULL;
+		}
+		line = journalNextCommand(journal);
+	}
+	return system;
+}
+
+/*
+ * Finishes the process after the input was read: saves the system to the
+ * checkpoint file (if one was given), syncs and closes the journal (if there
+ * is one), destroys the system and closes all the files.
+ */
+static void finishCommands(EscapeTechnion system, Journal journal,
+char* save_path, FILE* input_file, FILE* output_file, FILE* err_file) {
+	if(save_path) {
+		FILE* save_file = fopen(save_path, "wb");
+		if(!save_file)
+			mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+		else {
+			EscapeTechnionResult result = escapeTechnionSave(system, save_file);
+			if((fclose(save_file) != 0) && (result == ESCAPE_TECHNION_SUCCESS))
+				result = ESCAPE_TECHNION_CHECKPOINT_FAILED;
+			if(result == ESCAPE_TECHNION_OUT_OF_MEMORY)
+				mtmPrintErrorMessage(err_file, MTM_OUT_OF_MEMORY);
+			else if(result != ESCAPE_TECHNION_SUCCESS)
+				mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+		}
+	}
+	if(journal && (journalDestroy(journal) != JOURNAL_SUCCESS))
+		mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+	escapeTechnionDestroy(system); //destroy the system
+	CLOSE_FILES(input_file, output_file, err_file); //close all files
 }
 
 /*
@@ -429,46 +788,336 @@ CommandCode code, int parameters, FILE* err_file) {
  * or the command line). If a memory / command line problem is returned, the
  * function will stop reading its input.
  */
-static void getCommands(EscapeTechnion system, FILE* input_file,
-FILE* output_file, FILE* err_file) {
+static void getCommands(EscapeTechnion system, Journal journal,
+char* save_path, FILE* input_file, FILE* output_file, FILE* err_file) {
 	escapeTechnionModifyOutput(system, output_file);
-	char buffer[MAX_LEN+1] = {0}; //Terminate the string
-	char* words[MAX_COMMAND_WORDS];
-	for(int i=0; i<MAX_COMMAND_WORDS; i++) {
-		//We will store the function parameters inside this array.
-		words[i] = malloc((MAX_LEN+1));
-		if(!(words[i])) {
-			escapeTechnionDestroy(system);
-			mtmPrintErrorMessage(err_file, MTM_NULL_PARAMETER);
-			return;
-		}
-		words[i][MAX_LEN] = 0; //Terminate the string
+	if((input_file != stdin) && getMappedCommands(system, journal, input_file,
+	err_file)) {
+		finishCommands(system, journal, save_path, input_file, output_file,
+		err_file);
+		return;
 	}
-	int parameters = 0;
+	char buffer[MAX_LEN+1] = {0}; //Terminate the string
+	FieldSlice words[MAX_COMMAND_WORDS];
 	while(fgets(buffer, MAX_LEN+1, input_file) != NULL) {
-		CommandCode code = COMMAND_COMMENT;
-		if(!handleCommandLine(buffer, words, &code, &parameters,
-		err_file)) {
-			if(code == COMMAND_INVALID)
-				break; //command is invalid
+		const CommandEntry* entry = NULL;
+		int words_amount = splitLine(buffer, strlen(buffer), words);
+		LineType type = validCommandLine(words, words_amount, &entry,
+		err_file);
+		if(type == LINE_INVALID)
+			break; //command is invalid
+		if(type == LINE_COMMENT)
 			continue; //command is a comment
-		}
-		if(!translateCommand(system, words, code, parameters, err_file))
+		if(!executeCommand(system, journal, entry, words, err_file, true,
+		true))
 			break;
-		for(int i = 0; i<MAX_COMMAND_WORDS; i++)
-			words[i][MAX_LEN] = 0;
 	}
 	//End of file / fatal error occurred. Finish process:
-	for(int i=0; i<MAX_COMMAND_WORDS; i++)
-		free(words[i]);
-	escapeTechnionDestroy(system); //destroy the system
-	CLOSE_FILES(input_file, output_file, err_file); //close all files
+	finishCommands(system, journal, save_path, input_file, output_file,
+	err_file);
+}
+
+/*
+ * Opens the server's socket: a Unix domain stream socket, bound to a path and
+ * listening for connections.
+ * #return:
+ * 	-1 if the socket couldn't be opened, and the socket otherwise.
+ */
+static int openServerSocket(char* socket_path) {
+	assert(socket_path);
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(socket_path) >= sizeof(address.sun_path))
+		return -1;
+	strcpy(address.sun_path, socket_path);
+	int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listen_fd < 0)
+		return -1;
+	if((bind(listen_fd, (struct sockaddr*)&address, sizeof(address)) != 0) ||
+	(listen(listen_fd, SERVER_BACKLOG) != 0)) {
+		close(listen_fd);
+		return -1;
+	}
+	return listen_fd;
+}
+
+/*
+ * Finds the stripe of an escaper's lock by the email in a command line.
+ */
+static int escaperStripe(FieldSlice email) {
+	return (int)(hashWord(FNV_OFFSET_BASIS, email) & (LOCK_STRIPES - 1));
+}
+
+/*
+ * Finds the stripe of a room's lock by its faculty and id (the numbers of a
+ * command line, which might be invalid).
+ */
+static int roomStripe(int faculty, int id) {
+	return (int)(((unsigned int)id * (unsigned int)UNKNOWN +
+	(unsigned int)faculty) & (LOCK_STRIPES - 1));
+}
+
+/*
+ * Takes the system's lock (see the Server struct): alone, or shared with the
+ * other orders.
+ */
+static void lockSystem(Server* server, bool alone) {
+	assert(server);
+	pthread_mutex_lock(&(server->turnstile));
+	if(alone) {
+		pthread_rwlock_wrlock(&(server->system_lock));
+		pthread_mutex_unlock(&(server->turnstile));
+		return;
+	}
+	pthread_mutex_unlock(&(server->turnstile));
+	pthread_rwlock_rdlock(&(server->system_lock));
+}
+
+/*
+ * Takes the locks a command is executed under (see CommandLocks). The room of
+ * a recommendation is found once its escaper is locked, and if there's no
+ * such room, the recommendation fails without changing anything, so only its
+ * escaper is locked.
+ * 	$held: Where the locks that were taken are stored.
+ */
+static void lockCommand(Server* server, const CommandEntry* entry,
+FieldSlice* words, HeldLocks* held) {
+	assert(server && entry && words && held);
+	held->system = (entry->locks != LOCKS_NONE);
+	held->escaper = NO_STRIPE;
+	held->room = NO_STRIPE;
+	if(entry->locks == LOCKS_NONE)
+		return;
+	lockSystem(server, (entry->locks == LOCKS_SYSTEM));
+	if(entry->locks == LOCKS_SYSTEM)
+		return;
+	held->escaper = escaperStripe(words[PARAMETERS_INDEX]);
+	pthread_mutex_lock(&(server->escaper_locks[held->escaper]));
+	TechnionFaculty faculty = UNKNOWN;
+	int id = 0;
+	if(entry->locks == LOCKS_ORDER) {
+		faculty = (TechnionFaculty)readNumber(words[PARAMETERS_INDEX+1]);
+		id = readNumber(words[PARAMETERS_INDEX+2]);
+	}
+	else {
+		char email[MAX_LEN+1];
+		if(escapeTechnionRecommendedRoom(server->system,
+		wordString(words[PARAMETERS_INDEX], email),
+		readNumber(words[PARAMETERS_INDEX+1]), &faculty, &id) !=
+		ESCAPE_TECHNION_SUCCESS)
+			return;
+	}
+	held->room = roomStripe((int)faculty, id);
+	pthread_mutex_lock(&(server->room_locks[held->room]));
+}
+
+/*
+ * Releases the locks a command was executed under, in the opposite order.
+ */
+static void unlockCommand(Server* server, HeldLocks* held) {
+	assert(server && held);
+	if(held->room != NO_STRIPE)
+		pthread_mutex_unlock(&(server->room_locks[held->room]));
+	if(held->escaper != NO_STRIPE)
+		pthread_mutex_unlock(&(server->escaper_locks[held->escaper]));
+	if(held->system)
+		pthread_rwlock_unlock(&(server->system_lock));
+}
+
+/*
+ * Syncs the journal after a command that changed the system, so the command
+ * can be acknowledged (together with the commands other threads have appended
+ * meanwhile), and starts a snapshot if one is due. It's done after the
+ * command's locks were released, and a snapshot holds the system's lock
+ * alone, since it reads the whole system.
+ * #return:
+ * 	false - If the journal couldn't be written (the connection should no
+ * 	longer be read), true - otherwise.
+ */
+static bool commitCommand(Server* server, const CommandEntry* entry,
+FILE* err_file) {
+	assert(server && entry && err_file);
+	if(!(server->journal) || !(entry->changes_system))
+		return true;
+	if(journalCommit(server->journal) != JOURNAL_SUCCESS) {
+		mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+		return false;
+	}
+	if(journalSnapshotDue(server->journal)) {
+		lockSystem(server, true);
+		journalSnapshot(server->journal, server->system);
+		pthread_rwlock_unlock(&(server->system_lock));
+	}
+	return true;
+}
+
+/*
+ * Serves a single connection: reads its command lines until the client closes
+ * it, and executes them exactly like the lines of an input file. The errors
+ * are sent back on the connection, and the reports are printed to the
+ * system's output channel. An invalid command line (or a fatal error) ends the
+ * connection, the same way it ends the reading of an input file.
+ * Lines are read and split by the worker, and only the execution of a command
+ * (and its appending to the journal, so the journal keeps the order in which
+ * commands that depend on each other were executed) is done under its locks.
+ */
+static void serveClient(Server* server, int client_fd) {
+	assert(server && (client_fd >= 0));
+	int read_fd = dup(client_fd), write_fd = dup(client_fd);
+	FILE* client_in = (read_fd >= 0) ? fdopen(read_fd, "r") : NULL;
+	FILE* client_out = (write_fd >= 0) ? fdopen(write_fd, "w") : NULL;
+	if(!client_in || !client_out) {
+		if(client_in)
+			fclose(client_in);
+		else if(read_fd >= 0)
+			close(read_fd);
+		if(client_out)
+			fclose(client_out);
+		else if(write_fd >= 0)
+			close(write_fd);
+		return;
+	}
+	char buffer[MAX_LEN+1] = {0};
+	FieldSlice words[MAX_COMMAND_WORDS];
+	while(fgets(buffer, MAX_LEN+1, client_in) != NULL) {
+		const CommandEntry* entry = NULL;
+		int words_amount = splitLine(buffer, strlen(buffer), words);
+		LineType type = validCommandLine(words, words_amount, &entry,
+		client_out);
+		if(type == LINE_INVALID)
+			break;
+		if(type == LINE_COMMENT)
+			continue;
+		//Commands that only read the system read a published view of it, so
+		//they don't wait for the commands that change it.
+		HeldLocks held;
+		lockCommand(server, entry, words, &held);
+		bool keep_reading = executeCommand(server->system, server->journal,
+		entry, words, client_out, false, false);
+		unlockCommand(server, &held);
+		keep_reading = keep_reading && commitCommand(server, entry, client_out);
+		if(!keep_reading || (fflush(client_out) != 0))
+			break;
+	}
+	fclose(client_in);
+	fclose(client_out);
+}
+
+/*
+ * A thread's function for a worker of the server: accepts a connection,
+ * serves it, and then accepts the next one, until the server shuts down.
+ */
+static void* serverWorker(void* worker) {
+	ServerWorker* server_worker = worker;
+	assert(server_worker && server_worker->server);
+	Server* server = server_worker->server;
+	while(true) {
+		int client_fd = accept(server->listen_fd, NULL, NULL);
+		pthread_mutex_lock(&(server->clients_lock));
+		bool stopping = server->stopping;
+		if(!stopping && (client_fd >= 0))
+			server->clients[server_worker->index] = client_fd;
+		pthread_mutex_unlock(&(server->clients_lock));
+		if(stopping) {
+			if(client_fd >= 0)
+				close(client_fd);
+			return NULL;
+		}
+		if(client_fd < 0)
+			continue; //The connection was dropped before it was accepted.
+		serveClient(server, client_fd);
+		pthread_mutex_lock(&(server->clients_lock));
+		server->clients[server_worker->index] = -1;
+		pthread_mutex_unlock(&(server->clients_lock));
+		close(client_fd);
+	}
+}
+
+/*
+ * Runs the system as a server: instead of reading an input file, the command
+ * lines come from any amount of clients that connect to a Unix domain socket,
+ * and up to SERVER_WORKERS of them are served at the same time. The server
+ * runs until it gets SIGINT or SIGTERM, and then finishes like the batch mode
+ * does (the system is saved, the journal is synced and the files are closed).
+ */
+static void runServer(EscapeTechnion system, Journal journal,
+char* save_path, char* socket_path, FILE* output_file, FILE* err_file) {
+	assert(system && socket_path && output_file && err_file);
+	escapeTechnionModifyOutput(system, output_file);
+	Server server;
+	server.system = system;
+	server.journal = journal;
+	server.stopping = false;
+	for(int i=0; i<SERVER_WORKERS; i++)
+		server.clients[i] = -1;
+	server.listen_fd = openServerSocket(socket_path);
+	if(server.listen_fd < 0) {
+		mtmPrintErrorMessage(err_file, MTM_CANNOT_OPEN_FILE);
+		finishCommands(system, journal, save_path, stdin, output_file,
+		err_file);
+		return;
+	}
+	//A client that leaves in the middle shouldn't end the server, and the
+	//stopping signals are only waited for by this thread.
+	signal(SIGPIPE, SIG_IGN);
+	sigset_t stop_signals;
+	sigemptyset(&stop_signals);
+	sigaddset(&stop_signals, SIGINT);
+	sigaddset(&stop_signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+	pthread_rwlock_init(&(server.system_lock), NULL);
+	pthread_mutex_init(&(server.turnstile), NULL);
+	for(int i=0; i<LOCK_STRIPES; i++) {
+		pthread_mutex_init(&(server.escaper_locks[i]), NULL);
+		pthread_mutex_init(&(server.room_locks[i]), NULL);
+	}
+	pthread_mutex_init(&(server.clients_lock), NULL);
+	pthread_t threads[SERVER_WORKERS];
+	ServerWorker workers[SERVER_WORKERS];
+	bool started[SERVER_WORKERS] = {false};
+	for(int i=0; i<SERVER_WORKERS; i++) {
+		workers[i].server = &server;
+		workers[i].index = i;
+		started[i] = (pthread_create(&threads[i], NULL, serverWorker,
+		&workers[i]) == 0);
+	}
+	int stop_signal = 0;
+	sigwait(&stop_signals, &stop_signal);
+	//Shutting the sockets down wakes up the workers that wait for a
+	//connection or for a line, and each of them finishes its command first.
+	pthread_mutex_lock(&(server.clients_lock));
+	server.stopping = true;
+	shutdown(server.listen_fd, SHUT_RDWR);
+	for(int i=0; i<SERVER_WORKERS; i++)
+		if(server.clients[i] >= 0)
+			shutdown(server.clients[i], SHUT_RDWR);
+	pthread_mutex_unlock(&(server.clients_lock));
+	for(int i=0; i<SERVER_WORKERS; i++)
+		if(started[i])
+			pthread_join(threads[i], NULL);
+	close(server.listen_fd);
+	unlink(socket_path);
+	pthread_rwlock_destroy(&(server.system_lock));
+	pthread_mutex_destroy(&(server.turnstile));
+	for(int i=0; i<LOCK_STRIPES; i++) {
+		pthread_mutex_destroy(&(server.escaper_locks[i]));
+		pthread_mutex_destroy(&(server.room_locks[i]));
+	}
+	pthread_mutex_destroy(&(server.clients_lock));
+	finishCommands(system, journal, save_path, stdin, output_file, err_file);
 }
 
 int main(int argc, char** argv) {
 	FILE* input_file = stdin;
 	FILE* output_file = stdout;
 	FILE* err_file = stderr;
+	char* load_path = NULL;
+	char* save_path = NULL;
+	char* journal_path = NULL;
+	int report_workers = 1;
+	char* socket_path = NULL;
+	bool buffered_output = removeFlag(&argc, argv, BUFFERED_OUTPUT_FLAG);
 	if(!checkArgumentsNum(argc, err_file))
 		return 0;
 	for(int i=1; i<argc-1; i+=2) {
@@ -498,6 +1147,17 @@ int main(int argc, char** argv) {
 				return false;
 			}
 		}
+		else if((strcmp(argv[i], LOAD_FILE_FLAG) == 0) && !load_path)
+			load_path = argv[i+1];
+		else if((strcmp(argv[i], SAVE_FILE_FLAG) == 0) && !save_path)
+			save_path = argv[i+1];
+		else if((strcmp(argv[i], JOURNAL_FILE_FLAG) == 0) && !journal_path)
+			journal_path = argv[i+1];
+		else if((strcmp(argv[i], REPORT_WORKERS_FLAG) == 0) &&
+		(report_workers == 1) && (readWorkers(argv[i+1]) > 0))
+			report_workers = readWorkers(argv[i+1]);
+		else if((strcmp(argv[i], SERVER_SOCKET_FLAG) == 0) && !socket_path)
+			socket_path = argv[i+1];
 		else {
 			fclose(input_file);
 			fclose(output_file);
@@ -506,12 +1166,50 @@ int main(int argc, char** argv) {
 			return 0;
 		}
 	}
-	EscapeTechnion system = escapeTechnionCreate();
+	if((load_path && journal_path) || (socket_path && (input_file != stdin))) {
+		//The journal's own snapshot is where a durable system starts from, and
+		//a server gets its commands from its clients.
+		mtmPrintErrorMessage(err_file, MTM_INVALID_COMMAND_LINE_PARAMETERS);
+		CLOSE_FILES(input_file, output_file, err_file);
+		return 0;
+	}
+	buildDispatchTable();
+	JournalResult journal_result = JOURNAL_SUCCESS;
+	Journal journal = journal_path ? journalCreate(&journal_result,
+	journal_path) : NULL;
+	if(journal_path && !journal) {
+		mtmPrintErrorMessage(err_file,
+		(journal_result == JOURNAL_OUT_OF_MEMORY) ?
+		(MTM_OUT_OF_MEMORY) : (MTM_CANNOT_OPEN_FILE));
+		CLOSE_FILES(input_file, output_file, err_file);
+		return 0;
+	}
+	EscapeTechnion system = journal ? recoverSystem(journal, err_file) :
+	loadSystem(load_path, err_file);
 	if(!system) {
+		journalDestroy(journal);
+		CLOSE_FILES(input_file, output_file, err_file);
+		return 0;
+	}
+	EscapeTechnionResult result = buffered_output ?
+	escapeTechnionSetBufferedOutput(system, true) : ESCAPE_TECHNION_SUCCESS;
+	if(result == ESCAPE_TECHNION_SUCCESS)
+		result = escapeTechnionSetReportWorkers(system, report_workers);
+	if(result != ESCAPE_TECHNION_SUCCESS) {
+		mtmPrintErrorMessage(err_file,
+		(result == ESCAPE_TECHNION_OUT_OF_MEMORY) ?
+		(MTM_OUT_OF_MEMORY) : (MTM_INVALID_COMMAND_LINE_PARAMETERS));
+		journalDestroy(journal);
+		escapeTechnionDestroy(system);
 		CLOSE_FILES(input_file, output_file, err_file);
 		return 0;
 	}
 	//All went well with the initialization. Start reading input:
-	getCommands(system, input_file, output_file, err_file);
+	if(socket_path)
+		runServer(system, journal, save_path, socket_path, output_file,
+		err_file);
+	else
+		getCommands(system, journal, save_path, input_file, output_file,
+		err_file);
 	return 0;
 }
@@ -0,0 +1,139 @@
+#define _POSIX_C_SOURCE 200112L //For pthreads.
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "list_mtm/test_utilities.h"
+#include "../EscapeTechnion.h"
+
+#define ESCAPER_EMAIL "escaper@test"
+#define ESCAPER_FACULTY 3 //Not one of the rooms' faculties (no discount).
+#define EARNING_FACULTIES 3 //Faculties 0, 1 and 2 have a room each.
+#define PEOPLE 2 //The amount of people in every order.
+#define DAYS 200 //The amount of days the writer reports.
+#define LINE_LENGTH 256
+#define HEADER_FORMAT "The system has %d faculties and in %d days, they " \
+	"have made a revenue of %d"
+#define REVENUE_PREFIX "revenue of "
+
+//The entry fee of the room of every faculty that earns.
+static const int room_prices[EARNING_FACULTIES] = {4, 8, 12};
+
+/*
+ * The system the threads share, whether the reader has started reading it and
+ * whether the writer is done with it.
+ */
+typedef struct SharedSystem_t {
+	EscapeTechnion sys;
+	int started;
+	int done;
+} SharedSystem;
+
+/*
+ * The thread that changes the system: every day, the escaper orders each room
+ * once, and the day is reported (which is when the revenues change).
+ */
+static void* changeEarnings(void* shared_system) {
+	SharedSystem* shared = shared_system;
+	char time[LINE_LENGTH];
+	//The days are only changed while the reader reads them.
+	while(!__atomic_load_n(&(shared->started), __ATOMIC_ACQUIRE));
+	for(int day=0; day<DAYS; day++) {
+		for(int faculty=0; faculty<EARNING_FACULTIES; faculty++) {
+			sprintf(time, "0-%d", faculty);
+			escapeTechnionEscaperOrder(shared->sys, ESCAPER_EMAIL,
+			(TechnionFaculty)faculty, 1, time, PEOPLE);
+		}
+		escapeTechnionReportDay(shared->sys);
+	}
+	__atomic_store_n(&(shared->done), 1, __ATOMIC_RELEASE);
+	return NULL;
+}
+
+/*
+ * The thread that reads the system: reports the best faculties until the
+ * writer is done, without holding anything while the writer changes the
+ * system.
+ */
+static void* reportBest(void* shared_system) {
+	SharedSystem* shared = shared_system;
+	do {
+		escapeTechnionReportBest(shared->sys);
+		__atomic_store_n(&(shared->started), 1, __ATOMIC_RELEASE);
+	} while(!__atomic_load_n(&(shared->done), __ATOMIC_ACQUIRE));
+	return NULL;
+}
+
+/*
+ * Reads the revenue at the end of a faculty's line of the best faculties.
+ */
+static bool readRevenue(char* line, int* revenue) {
+	char* start = strstr(line, REVENUE_PREFIX);
+	return start && (sscanf(start + strlen(REVENUE_PREFIX), "%d",
+	revenue) == 1);
+}
+
+/*
+ * Reports the best faculties while another thread changes the earnings, and
+ * checks that every report is consistent with a single day: the revenues all
+ * belong to the day in the report's header, as they would if the report had
+ * been printed between two commands. The reports are printed one after the
+ * other, so their days never go back: a view that was published before its
+ * fields were written would show an older day than a report before it.
+ */
+static bool testReportBestWhileChanging() {
+	EscapeTechnion sys = escapeTechnionCreate();
+	FILE* output = tmpfile();
+	ASSERT_TEST(sys && output);
+	ASSERT_TEST(escapeTechnionModifyOutput(sys, output) ==
+	ESCAPE_TECHNION_SUCCESS);
+	char email[LINE_LENGTH];
+	for(int faculty=0; faculty<EARNING_FACULTIES; faculty++) {
+		sprintf(email, "company%d@test", faculty);
+		ASSERT_TEST(escapeTechnionAddCompany(sys, email,
+		(TechnionFaculty)faculty) == ESCAPE_TECHNION_SUCCESS);
+		ASSERT_TEST(escapeTechnionAddRoom(sys, email, 1, room_prices[faculty],
+		PEOPLE, "00-24", 1) == ESCAPE_TECHNION_SUCCESS);
+	}
+	ASSERT_TEST(escapeTechnionAddEscaper(sys, ESCAPER_EMAIL,
+	(TechnionFaculty)ESCAPER_FACULTY, 1) == ESCAPE_TECHNION_SUCCESS);
+	SharedSystem shared = {sys, 0, 0};
+	pthread_t writer, reader;
+	ASSERT_TEST(pthread_create(&writer, NULL, changeEarnings, &shared) == 0);
+	ASSERT_TEST(pthread_create(&reader, NULL, reportBest, &shared) == 0);
+	pthread_join(writer, NULL);
+	pthread_join(reader, NULL);
+	//A report is printed as a whole, so its lines are never split by the
+	//day reports.
+	rewind(output);
+	char line[LINE_LENGTH];
+	int reports = 0, faculties = 0, days = 0, last_days = 0, total = 0,
+	revenue = 0;
+	while(fgets(line, LINE_LENGTH, output)) {
+		if(sscanf(line, HEADER_FORMAT, &faculties, &days, &total) != 3)
+			continue;
+		int daily_total = 0;
+		for(int faculty=0; faculty<EARNING_FACULTIES; faculty++)
+			daily_total += room_prices[faculty]*PEOPLE;
+		ASSERT_TEST((days >= last_days) && (days <= DAYS));
+		last_days = days;
+		ASSERT_TEST(total == days*daily_total);
+		//The faculty with the most expensive room is the best one.
+		for(int faculty=EARNING_FACULTIES-1; faculty>=0; faculty--) {
+			ASSERT_TEST(fgets(line, LINE_LENGTH, output));
+			ASSERT_TEST(readRevenue(line, &revenue));
+			ASSERT_TEST(revenue == days*room_prices[faculty]*PEOPLE);
+		}
+		reports++;
+	}
+	ASSERT_TEST(reports > 0);
+	escapeTechnionDestroy(sys);
+	fclose(output);
+	return true;
+}
+
+int main() {
+	RUN_TEST(testReportBestWhileChanging);
+	return 0;
+}
@@ -0,0 +1,63 @@
+#!/bin/sh
+#Runs mtm_escape on a synthetic workload and reports its throughput.
+#Usage: bench.sh <mtm_escape> <workload_gen> [generator flags] [-- program flags]
+#The generator flags set the size of the workload (see tests/workload_gen.c),
+#and the program flags are passed to mtm_escape (for example: -b -p 4).
+#The workload is generated twice: only its setup phase, and all of it. The
+#program runs on both, and the time of the days phase is the difference.
+
+EXEC=$1
+GENERATOR=$2
+shift 2
+GEN_FLAGS=""
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	GEN_FLAGS="$GEN_FLAGS $1"
+	shift
+done
+[ "$1" = "--" ] && shift
+EXEC_FLAGS="$*"
+
+WORK_DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+#The current time, in nanoseconds.
+now() {
+	date +%s%N
+}
+
+#Runs the program on an input file (the output isn't kept) and prints the
+#amount of nanoseconds it took.
+run() {
+	start=$(now)
+	$EXEC $EXEC_FLAGS -i "$1" > /dev/null 2>&1
+	end=$(now)
+	echo $((end - start))
+}
+
+#Prints a phase's line: its name, its commands and nanoseconds.
+report() {
+	awk -v name="$1" -v commands="$2" -v time="$3" 'BEGIN {
+		seconds = time / 1e9
+		rate = (seconds > 0) ? (commands / seconds) : 0
+		printf "%-10s %10d commands %10.3f s %14.0f commands/s\n",
+		name, commands, seconds, rate
+	}'
+}
+
+start=$(now)
+$GENERATOR $GEN_FLAGS -p setup > "$WORK_DIR/setup.in" || exit 1
+$GENERATOR $GEN_FLAGS -p days > "$WORK_DIR/full.in" || exit 1
+generate_time=$(($(now) - start))
+
+setup_commands=$(wc -l < "$WORK_DIR/setup.in")
+total_commands=$(wc -l < "$WORK_DIR/full.in")
+setup_time=$(run "$WORK_DIR/setup.in")
+total_time=$(run "$WORK_DIR/full.in")
+
+echo "Workload:$GEN_FLAGS"
+echo "Program flags: ${EXEC_FLAGS:-none}"
+report generate $((setup_commands + total_commands)) "$generate_time"
+report setup "$setup_commands" "$setup_time"
+report days $((total_commands - setup_commands)) \
+	$((total_time - setup_time))
+report total "$total_commands" "$total_time"
@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <assert.h>
+#include "../Field.h"
+#include "../mtm_ex3.h"
+
+/*
+ * A generator of synthetic workloads for mtm_escape: it prints a valid stream
+ * of commands to the standard output. The stream has two phases:
+ * 	setup - the companies, their rooms and the escapers are added.
+ * 	days - every day, escapers order rooms or ask for a recommendation, and
+ * 	then the day is reported. The best faculties are reported at the end.
+ * The stream only depends on the parameters (and the seed), so a workload can
+ * be generated again to compare two versions of the program.
+ * Usage: workload_gen [-c companies] [-r rooms] [-e escapers] [-o orders]
+ * 	[-R recommend] [-d days] [-s seed] [-p phase]
+ * 	$companies: The amount of companies.
+ * 	$rooms: The amount of rooms of every company.
+ * 	$escapers: The amount of escapers.
+ * 	$orders: The amount of orders (and recommendations) every day.
+ * 	$recommend: The percentage of the orders that are recommendations.
+ * 	$days: The amount of days.
+ * 	$seed: The seed of the generator's random numbers.
+ * 	$phase: The last phase that's printed: "setup" or "days" (the default).
+ */
+
+#define COMPANIES_FLAG "-c"
+#define ROOMS_FLAG "-r"
+#define ESCAPERS_FLAG "-e"
+#define ORDERS_FLAG "-o"
+#define RECOMMEND_FLAG "-R"
+#define DAYS_FLAG "-d"
+#define SEED_FLAG "-s"
+#define PHASE_FLAG "-p"
+#define SETUP_PHASE "setup"
+#define DAYS_PHASE "days"
+
+#define COMPANY_EMAIL "company%d@bench" //The email of the i-th company.
+#define ESCAPER_EMAIL "escaper%d@bench" //The email of the i-th escaper.
+#define WORKING_HOURS "00-24" //The rooms are open all day.
+#define MAX_PEOPLE 6 //The most people an order (or a room) is for.
+#define MAX_LEVEL 10 //The maximum skill / difficulty.
+#define MAX_FEE 50 //Entry fees are multiples of 4, of at most 4*MAX_FEE.
+#define FEE_MULTIPLE 4 //Entry fees must be multiples of this.
+#define HOURS_IN_A_DAY 24
+#define PERCENT 100
+
+/*
+ * The parameters of a workload.
+ */
+typedef struct Workload_t {
+	int companies;
+	int rooms;
+	int escapers;
+	int orders;
+	int recommend;
+	int days;
+	int seed;
+	bool setup_only;
+} Workload;
+
+static unsigned int random_state = 1; //The state of the random numbers.
+
+static int randomBelow(int bound);
+static bool readParameter(Workload* workload, char* flag, char* value);
+static void printSetup(Workload* workload);
+static void printDays(Workload* workload);
+
+/*
+ * Returns a pseudo-random number between 0 and bound-1. The numbers come from
+ * our own generator (and not from rand), so a seed makes the same workload on
+ * every platform.
+ */
+static int randomBelow(int bound) {
+	assert(bound > 0);
+	random_state = random_state*1103515245u + 12345u;
+	return (int)((random_state >> 16) % (unsigned int)bound);
+}
+
+/*
+ * Reads a parameter of the workload from its flag and value.
+ * #return:
+ * 	false if the flag is unknown or the value isn't legal for it,
+ * 	and true otherwise.
+ */
+static bool readParameter(Workload* workload, char* flag, char* value) {
+	assert(workload && flag && value);
+	if(strcmp(flag, PHASE_FLAG) == 0) {
+		workload->setup_only = (strcmp(value, SETUP_PHASE) == 0);
+		return workload->setup_only || (strcmp(value, DAYS_PHASE) == 0);
+	}
+	int number = 0;
+	if(!fieldReadInteger(value, &number) || (number < 0))
+		return false;
+	if(strcmp(flag, COMPANIES_FLAG) == 0)
+		workload->companies = number;
+	else if(strcmp(flag, ROOMS_FLAG) == 0)
+		workload->rooms = number;
+	else if(strcmp(flag, ESCAPERS_FLAG) == 0)
+		workload->escapers = number;
+	else if(strcmp(flag, ORDERS_FLAG) == 0)
+		workload->orders = number;
+	else if((strcmp(flag, RECOMMEND_FLAG) == 0) && (number <= PERCENT))
+		workload->recommend = number;
+	else if(strcmp(flag, DAYS_FLAG) == 0)
+		workload->days = number;
+	else if(strcmp(flag, SEED_FLAG) == 0)
+		workload->seed = number;
+	else
+		return false;
+	return true;
+}
+
+/*
+ * Prints the setup phase: the companies with their rooms, and the escapers.
+ * The i-th company belongs to the faculty i%UNKNOWN, so the room ids are
+ * counted in every faculty separately.
+ */
+static void printSetup(Workload* workload) {
+	assert(workload);
+	for(int i=0; i<workload->companies; i++) {
+		printf("company add " COMPANY_EMAIL " %d\n", i, i % (int)UNKNOWN);
+		for(int j=0; j<workload->rooms; j++)
+			printf("room add " COMPANY_EMAIL " %d %d %d " WORKING_HOURS " %d\n",
+			i, (i / (int)UNKNOWN)*(workload->rooms) + j + 1,
+			FEE_MULTIPLE*(randomBelow(MAX_FEE)+1), randomBelow(MAX_PEOPLE)+1,
+			randomBelow(MAX_LEVEL)+1);
+	}
+	for(int i=0; i<workload->escapers; i++)
+		printf("escaper add " ESCAPER_EMAIL " %d %d\n", i,
+		randomBelow((int)UNKNOWN), randomBelow(MAX_LEVEL)+1);
+}
+
+/*
+ * Prints the days phase: every day has the workload's amount of orders and
+ * recommendations of random escapers, and ends with the day's report. Orders
+ * are for random rooms and hours of the same day, so a few of them fail for
+ * a busy room or escaper, like they would in a real day.
+ */
+static void printDays(Workload* workload) {
+	assert(workload);
+	//The amount of companies (and so of rooms) in the faculty with the most.
+	int faculty_companies = (workload->companies + (int)UNKNOWN-1) /
+	(int)UNKNOWN;
+	for(int day=0; day<workload->days; day++) {
+		for(int i=0; (i<workload->orders) && (workload->escapers > 0); i++) {
+			int escaper = randomBelow(workload->escapers),
+			people = randomBelow(MAX_PEOPLE)+1;
+			if(randomBelow(PERCENT) < workload->recommend) {
+				printf("escaper recommend " ESCAPER_EMAIL " %d\n", escaper,
+				people);
+				continue;
+			}
+			if((workload->companies == 0) || (workload->rooms == 0))
+				continue;
+			int company = randomBelow(workload->companies);
+			printf("escaper order " ESCAPER_EMAIL " %d %d 0-%d %d\n", escaper,
+			company % (int)UNKNOWN, (company / (int)UNKNOWN)*(workload->rooms) +
+			randomBelow(workload->rooms) + 1, randomBelow(HOURS_IN_A_DAY),
+			people);
+		}
+		printf("report day\n");
+	}
+	if(faculty_companies > 0)
+		printf("report best\n");
+}
+
+int main(int argc, char** argv) {
+	Workload workload = {
+		.companies = 100,
+		.rooms = 10,
+		.escapers = 1000,
+		.orders = 500,
+		.recommend = 20,
+		.days = 30,
+		.seed = 1,
+		.setup_only = false,
+	};
+	if(argc % 2 == 0) {
+		fprintf(stderr, "Every flag of the workload needs a value\n");
+		return 1;
+	}
+	for(int i=1; i<argc-1; i+=2) {
+		if(!readParameter(&workload, argv[i], argv[i+1])) {
+			fprintf(stderr, "Invalid parameter: %s %s\n", argv[i], argv[i+1]);
+			return 1;
+		}
+	}
+	random_state = (unsigned int)workload.seed;
+	printSetup(&workload);
+	if(!workload.setup_only)
+		printDays(&workload);
+	return 0;
+}